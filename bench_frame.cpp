@@ -0,0 +1,423 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+// Headless frame benchmark. Drives imguiBeginFrame..imguiEndFrame with
+// scripted input over a synthetic UI and reports the cost per frame.
+//
+//   c++ -O2 -std=c++11 -pthread bench_frame.cpp imgui.cpp imguiCapture.cpp imguiRenderSoft.cpp -o bench_frame
+//   ./bench_frame --areas 8 --widgets 100 --mix text --frames 2000 --json
+//
+// --check-allocs fails unless every frame after the warmup runs without heap
+// allocations, counting both the imgui allocator hooks and operator new.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "imguiCapture.h"
+#include "imguiProfiler.h"
+#include "imguiRenderSoft.h"
+
+enum Mix
+{
+    MIX_MIXED,
+    MIX_TEXT,
+    MIX_SHAPE,
+};
+
+struct Options
+{
+    int areas;
+    int widgets;
+    int mix;
+    int frames;
+    int warmup;
+    int width, height;
+    bool json;
+    const char* render;
+    int threads;
+    const char* font;
+    const char* capture;
+    const char* trace;
+    bool checkAllocs;
+    bool help;
+};
+
+static const char* g_mixNames[] = { "mixed", "text", "shape" };
+
+// Counts operator new while set, to catch heap use outside the imgui hooks.
+static bool g_countNew = false;
+static long long g_newCount = 0;
+
+void* operator new(size_t size)
+{
+    if (g_countNew)
+        g_newCount++;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+static const char* g_paragraph =
+    "Immediate mode UIs rebuild their command stream every frame. "
+    "This paragraph wraps to the width of its scroll area.";
+
+struct UiState
+{
+    std::vector<int> scroll;
+    std::vector<float> values;
+    std::vector<bool> checks;
+};
+
+// Deterministic input script: a Lissajous mouse path, a click every 30
+// frames and a scroll tick every 17 frames.
+static void scriptedInput(int frame, const Options& opt, int* mx, int* my, unsigned char* mbut, int* scroll)
+{
+    const int t = frame % 720;
+    const int tx = t < 360 ? t : 720 - t;
+    const int ty = (t*3/2) % 720 < 360 ? (t*3/2) % 720 : 720 - (t*3/2) % 720;
+    *mx = tx * (opt.width-1) / 360;
+    *my = ty * (opt.height-1) / 360;
+    *mbut = (frame % 30) < 5 ? IMGUI_MBUT_LEFT : 0;
+    *scroll = (frame % 17) == 0 ? ((frame / 17) % 2 ? 1 : -1) : 0;
+}
+
+static void buildWidget(int kind, int i, UiState& ui, char* buf, int bufSize)
+{
+    switch (kind)
+    {
+    case 0: imguiLabel("Label"); break;
+    case 1: snprintf(buf, bufSize, "Value %d", i); imguiValue(buf); break;
+    case 2: imguiParagraph(g_paragraph); break;
+    case 3: imguiItem("Item"); break;
+    case 4: if (imguiButton("Button")) ui.checks[i] = !ui.checks[i]; break;
+    case 5: if (imguiCheck("Checkbox", ui.checks[i])) ui.checks[i] = !ui.checks[i]; break;
+    case 6: imguiSlider("Slider", &ui.values[i], 0.f, 100.f, 1.f); break;
+    case 7: imguiSeparatorLine(); break;
+    case 8: if (imguiCollapse("Collapse", "subtext", ui.checks[i])) ui.checks[i] = !ui.checks[i]; break;
+    }
+}
+
+static void buildFrame(const Options& opt, UiState& ui)
+{
+    static const int textKinds[] = { 0, 1, 2, 3 };
+    static const int shapeKinds[] = { 4, 5, 6, 7 };
+    static const int mixedKinds[] = { 0, 1, 2, 3, 4, 5, 6, 7, 8 };
+
+    const int* kinds = mixedKinds;
+    int nkinds = 9;
+    if (opt.mix == MIX_TEXT) { kinds = textKinds; nkinds = 4; }
+    if (opt.mix == MIX_SHAPE) { kinds = shapeKinds; nkinds = 4; }
+
+    const int cols = opt.areas < 4 ? opt.areas : 4;
+    const int rows = (opt.areas + cols-1) / cols;
+    const int aw = opt.width / cols;
+    const int ah = opt.height / rows;
+
+    char buf[64];
+    for (int a = 0; a < opt.areas; ++a)
+    {
+        const int x = (a % cols) * aw;
+        const int y = (a / cols) * ah;
+        imguiBeginScrollArea("Scroll area", x+5, y+5, aw-10, ah-10, &ui.scroll[a]);
+        for (int w = 0; w < opt.widgets; ++w)
+        {
+            const int i = a*opt.widgets + w;
+            buildWidget(kinds[w % nkinds], i, ui, buf, sizeof(buf));
+        }
+        imguiEndScrollArea();
+    }
+
+    if (opt.mix == MIX_SHAPE)
+    {
+        for (int i = 0; i < opt.widgets; ++i)
+        {
+            const float x = (float)(i*37 % opt.width);
+            const float y = (float)(i*53 % opt.height);
+            imguiDrawRoundedRect(x, y, 40, 24, 6, imguiRGBA(32,192,32,192));
+            imguiDrawLine(x, y, x+40, y+24, 2, imguiRGBA(192,32,32,192));
+        }
+    }
+}
+
+static bool parseOptions(int argc, char** argv, Options& opt)
+{
+    opt.areas = 4;
+    opt.widgets = 50;
+    opt.mix = MIX_MIXED;
+    opt.frames = 1000;
+    opt.warmup = 100;
+    opt.width = 1920;
+    opt.height = 1080;
+    opt.json = false;
+    opt.render = 0;
+    opt.threads = 0;
+    opt.font = "DroidSans.ttf";
+    opt.capture = 0;
+    opt.trace = 0;
+    opt.checkAllocs = false;
+    opt.help = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const bool missing = i+1 >= argc;
+        const char* val = missing ? "" : argv[i+1];
+        if (strcmp(arg, "--json") == 0) { opt.json = true; continue; }
+        if (strcmp(arg, "--check-allocs") == 0) { opt.checkAllocs = true; continue; }
+        if (strcmp(arg, "-h") == 0 || strcmp(arg, "--help") == 0) { opt.help = true; return true; }
+        if (strcmp(arg, "--areas") == 0) opt.areas = atoi(val);
+        else if (strcmp(arg, "--widgets") == 0) opt.widgets = atoi(val);
+        else if (strcmp(arg, "--frames") == 0) opt.frames = atoi(val);
+        else if (strcmp(arg, "--warmup") == 0) opt.warmup = atoi(val);
+        else if (strcmp(arg, "--width") == 0) opt.width = atoi(val);
+        else if (strcmp(arg, "--height") == 0) opt.height = atoi(val);
+        else if (strcmp(arg, "--render") == 0) opt.render = val;
+        else if (strcmp(arg, "--threads") == 0) opt.threads = atoi(val);
+        else if (strcmp(arg, "--font") == 0) opt.font = val;
+        else if (strcmp(arg, "--capture") == 0) opt.capture = val;
+        else if (strcmp(arg, "--trace") == 0) opt.trace = val;
+        else if (strcmp(arg, "--mix") == 0)
+        {
+            opt.mix = -1;
+            for (int m = 0; m < 3; ++m)
+                if (strcmp(val, g_mixNames[m]) == 0)
+                    opt.mix = m;
+            if (opt.mix < 0 && !missing) { fprintf(stderr, "Unknown mix '%s'\n", val); return false; }
+        }
+        else { fprintf(stderr, "Unknown option '%s'\n", arg); return false; }
+        if (missing) { fprintf(stderr, "Missing value for %s\n", arg); return false; }
+        ++i;
+    }
+    if (opt.areas < 1 || opt.widgets < 0 || opt.frames < 1 || opt.width < 1 || opt.height < 1)
+    {
+        fprintf(stderr, "Invalid workload.\n");
+        return false;
+    }
+    if (opt.render && strcmp(opt.render, "soft") != 0 && strcmp(opt.render, "tiled") != 0)
+    {
+        fprintf(stderr, "Unknown renderer '%s' (soft, tiled)\n", opt.render);
+        return false;
+    }
+    return true;
+}
+
+static bool loadFile(const char* path, std::string& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        data.append(buf, n);
+    fclose(fp);
+    return true;
+}
+
+static void printUsage(FILE* fp, const char* program)
+{
+    fprintf(fp, "usage: %s [--areas N] [--widgets M] [--mix mixed|text|shape] [--frames F] [--warmup W]\n"
+                "       [--width W] [--height H] [--render soft|tiled] [--threads T] [--font path]\n"
+                "       [--capture out.imq] [--trace out.json] [--check-allocs] [--json]\n", program);
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseOptions(argc, argv, opt))
+    {
+        printUsage(stderr, argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (opt.help)
+    {
+        printUsage(stdout, argv[0]);
+        return EXIT_SUCCESS;
+    }
+
+    std::vector<unsigned int> pixels;
+    if (opt.render)
+    {
+        std::string ttf;
+        if (!loadFile(opt.font, ttf) || !imguiRenderSoftInit((const unsigned char*)ttf.data()))
+        {
+            fprintf(stderr, "Could not load font '%s'.\n", opt.font);
+            return EXIT_FAILURE;
+        }
+        pixels.resize((size_t)opt.width*opt.height);
+    }
+
+#ifndef IMGUI_ENABLE_PROFILER
+    if (opt.trace)
+    {
+        fprintf(stderr, "--trace needs a build with -DIMGUI_ENABLE_PROFILER and imguiProfiler.cpp.\n");
+        return EXIT_FAILURE;
+    }
+#endif
+    if (opt.capture && !imguiCaptureBegin(opt.capture))
+    {
+        fprintf(stderr, "Could not create capture '%s'.\n", opt.capture);
+        return EXIT_FAILURE;
+    }
+
+    UiState ui;
+    const int count = opt.areas*opt.widgets;
+    ui.scroll.assign(opt.areas, 0);
+    ui.values.assign(count, 50.f);
+    ui.checks.assign(count, false);
+
+    std::vector<double> buildNs, renderNs;
+    buildNs.reserve(opt.frames);
+    renderNs.reserve(opt.frames);
+    double commands = 0, textBytes = 0, damageRects = 0, damageArea = 0;
+    int unchangedFrames = 0;
+    long long allocations = 0;
+    int allocFrames = 0, firstAllocFrame = -1;
+
+    typedef std::chrono::steady_clock Clock;
+    for (int frame = 0; frame < opt.warmup + opt.frames; ++frame)
+    {
+        int mx, my, scroll;
+        unsigned char mbut;
+        scriptedInput(frame, opt, &mx, &my, &mbut, &scroll);
+        g_countNew = frame >= opt.warmup;
+        const long long newCount = g_newCount;
+
+        const Clock::time_point t0 = Clock::now();
+        imguiBeginFrame(mx, my, mbut, scroll);
+        buildFrame(opt, ui);
+        imguiEndFrame();
+        const Clock::time_point t1 = Clock::now();
+
+        if (opt.render)
+        {
+            imguiRenderSoftClear(&pixels[0], opt.width, opt.height, opt.width, imguiRGBA(204,204,204));
+            if (strcmp(opt.render, "tiled") == 0)
+                imguiRenderSoftDrawTiled(&pixels[0], opt.width, opt.height, opt.width, opt.threads);
+            else
+                imguiRenderSoftDraw(&pixels[0], opt.width, opt.height, opt.width);
+        }
+        const Clock::time_point t2 = Clock::now();
+
+        if (frame < opt.warmup)
+            continue;
+        buildNs.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+        renderNs.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t2 - t1).count());
+        commands += imguiGetRenderQueueSize();
+        textBytes += imguiGetTextPoolSize();
+
+        if (!imguiFrameChanged())
+            unchangedFrames++;
+
+        const imguiDamageRect* damage = imguiGetDamageRects();
+        const int ndamage = imguiGetDamageRectCount();
+        damageRects += ndamage;
+        for (int i = 0; i < ndamage; ++i)
+            damageArea += (double)damage[i].w*damage[i].h;
+
+        const long long frameAllocs = imguiGetFrameStats()->allocations + (g_newCount - newCount);
+        allocations += frameAllocs;
+        if (frameAllocs > 0)
+        {
+            allocFrames++;
+            if (firstAllocFrame < 0)
+                firstAllocFrame = frame - opt.warmup;
+        }
+
+        // After counting, since the capture buffer and index grow with the file.
+        if (opt.capture)
+            imguiCaptureFrame(opt.width, opt.height);
+    }
+    g_countNew = false;
+
+    if (opt.render)
+        imguiRenderSoftDestroy();
+    if (opt.capture)
+        imguiCaptureEnd();
+#ifdef IMGUI_ENABLE_PROFILER
+    if (opt.trace && !imguiProfileWriteTrace(opt.trace))
+        fprintf(stderr, "Could not write trace '%s'.\n", opt.trace);
+#endif
+
+    double buildMean = 0, renderMean = 0;
+    for (int i = 0; i < opt.frames; ++i)
+    {
+        buildMean += buildNs[i];
+        renderMean += renderNs[i];
+    }
+    buildMean /= opt.frames;
+    renderMean /= opt.frames;
+    commands /= opt.frames;
+    textBytes /= opt.frames;
+    damageRects /= opt.frames;
+    damageArea /= opt.frames;
+
+    std::sort(buildNs.begin(), buildNs.end());
+    const double buildMin = buildNs[0];
+    const double buildMedian = buildNs[opt.frames/2];
+    const double buildP99 = buildNs[(opt.frames-1)*99/100];
+
+    if (opt.json)
+    {
+        printf("{\"areas\": %d, \"widgets\": %d, \"mix\": \"%s\", \"frames\": %d, "
+               "\"ns_per_frame\": %.0f, \"ns_per_frame_min\": %.0f, \"ns_per_frame_median\": %.0f, \"ns_per_frame_p99\": %.0f, "
+               "\"commands_per_frame\": %.1f, \"text_bytes_per_frame\": %.1f, "
+               "\"damage_rects_per_frame\": %.1f, \"damage_pixels_per_frame\": %.0f, \"unchanged_frames\": %d, "
+               "\"allocations\": %lld, \"allocating_frames\": %d",
+               opt.areas, opt.widgets, g_mixNames[opt.mix], opt.frames,
+               buildMean, buildMin, buildMedian, buildP99, commands, textBytes, damageRects, damageArea, unchangedFrames,
+               allocations, allocFrames);
+        if (opt.render)
+            printf(", \"render\": \"%s\", \"threads\": %d, \"render_ns_per_frame\": %.0f", opt.render, opt.threads, renderMean);
+        printf("}\n");
+    }
+    else
+    {
+        printf("workload          %d areas x %d widgets, %s, %d frames\n", opt.areas, opt.widgets, g_mixNames[opt.mix], opt.frames);
+        printf("ns/frame          mean %.0f  min %.0f  median %.0f  p99 %.0f\n", buildMean, buildMin, buildMedian, buildP99);
+        printf("commands/frame    %.1f\n", commands);
+        printf("text bytes/frame  %.1f\n", textBytes);
+        printf("damage/frame      %.1f rects, %.0f pixels\n", damageRects, damageArea);
+        printf("unchanged frames  %d\n", unchangedFrames);
+        printf("allocations       %lld in %d frames\n", allocations, allocFrames);
+        if (opt.render)
+            printf("render ns/frame   %.0f (%s, %d threads)\n", renderMean, opt.render, opt.threads);
+    }
+
+    if (opt.checkAllocs && allocations > 0)
+    {
+        fprintf(stderr, "%lld heap allocations after warmup, first in frame %d.\n", allocations, firstAllocFrame);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
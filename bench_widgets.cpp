@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+// Per-widget micro-benchmark. Times each public widget and draw call in
+// batches inside a frame and reports ns/call and the queue, text pool and
+// point pool bytes each call consumes. Then times the GL-free tessellation
+// of each command kind taken from a frame using every widget.
+//
+//   c++ -O2 -std=c++11 bench_widgets.cpp imgui.cpp imguiTessellate.cpp -o bench_widgets
+//   ./bench_widgets --calls 50000 --font DroidSans.ttf --json
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "imguiTessellate.h"
+
+typedef std::chrono::steady_clock Clock;
+
+static const int AREA_WIDTH = 300;
+static const int AREA_HEIGHT = 4000;
+static const int PLOT_SAMPLES = 10000;
+
+static bool g_checked = false;
+static float g_sliderValue = 50.f;
+static float g_plotValues[PLOT_SAMPLES];
+static int g_scroll = 0;
+
+static const char* g_paragraph =
+    "Immediate mode UIs rebuild their command stream every frame. "
+    "This paragraph wraps to the width of its scroll area.";
+
+static void callButton(int) { imguiButton("Button"); }
+static void callButtonDisabled(int) { imguiButton("Button", false); }
+static void callItem(int) { imguiItem("Item"); }
+static void callCheck(int) { imguiCheck("Checkbox", g_checked); }
+static void callCollapse(int) { imguiCollapse("Collapse", "subtext", g_checked); }
+static void callLabel(int) { imguiLabel("Label"); }
+static void callValue(int) { imguiValue("Value"); }
+static void callParagraph(int) { imguiParagraph(g_paragraph); }
+static void callSlider(int) { imguiSlider("Slider", &g_sliderValue, 0.f, 100.f, 1.f); }
+static void callSeparator(int) { imguiSeparator(); }
+static void callSeparatorLine(int) { imguiSeparatorLine(); }
+static void callIndent(int) { imguiIndent(); imguiUnindent(); }
+static void callPlot(int) { imguiPlot("Plot", g_plotValues, PLOT_SAMPLES, -1.f, 1.f, 40); }
+static void callPlotArea(int) { imguiPlot("Plot", g_plotValues, PLOT_SAMPLES, -1.f, 1.f, 40, IMGUI_PLOT_AREA); }
+
+static void callScrollArea(int)
+{
+    imguiBeginScrollArea("Scroll area", 10, 10, AREA_WIDTH, 200, &g_scroll);
+    imguiEndScrollArea();
+}
+
+static void callDrawText(int i)
+{
+    imguiDrawText(10 + i%50*10, 10 + i%40*10, IMGUI_ALIGN_LEFT, "Draw text", imguiRGBA(255,255,255,200));
+}
+
+static void callDrawLine(int i)
+{
+    const float x = (float)(10 + i%50*10), y = (float)(10 + i%40*10);
+    imguiDrawLine(x, y, x+100, y+20, 2.f, imguiRGBA(255,255,255,200));
+}
+
+static void callDrawRect(int i)
+{
+    imguiDrawRect((float)(10 + i%50*10), (float)(10 + i%40*10), 100, 20, imguiRGBA(255,255,255,200));
+}
+
+static void callDrawRoundedRect(int i)
+{
+    imguiDrawRoundedRect((float)(10 + i%50*10), (float)(10 + i%40*10), 100, 20, 6.f, imguiRGBA(255,255,255,200));
+}
+
+static void callDrawPolyline(int i)
+{
+    static float path[32*2];
+    const float x = (float)(10 + i%50*10), y = (float)(10 + i%40*10);
+    for (int k = 0; k < 32; ++k)
+    {
+        path[k*2] = x + k*4.f;
+        path[k*2+1] = y + (k & 1 ? 12.f : 0.f) + k*0.5f;
+    }
+    imguiDrawPolyline(path, 32, 2.f, imguiRGBA(255,255,255,200));
+}
+
+static void callDrawCircle(int i)
+{
+    imguiDrawCircle((float)(20 + i%50*10), (float)(20 + i%40*10), 8.f, imguiRGBA(255,255,255,200));
+}
+
+static void callDrawEllipseRing(int i)
+{
+    imguiDrawEllipse((float)(40 + i%50*10), (float)(30 + i%40*10), 30.f, 16.f, imguiRGBA(255,255,255,200), 2.f);
+}
+
+static void callDrawMarkers(int i)
+{
+    static float centers[256*2];
+    for (int k = 0; k < 256; ++k)
+    {
+        centers[k*2] = (float)(10 + (k*37 + i*13) % 600);
+        centers[k*2+1] = (float)(10 + (k*91 + i*7) % 400);
+    }
+    imguiDrawMarkers(centers, 256, 3.f, imguiRGBA(255,196,0,255));
+}
+
+static void callImage(int i)
+{
+    // 16x16 cells of a 256x256 atlas, four handles.
+    const float u = (float)(i & 15)/16.f, v = (float)((i >> 4) & 15)/16.f;
+    imguiImage(1 + (unsigned)(i >> 8 & 3), u, v, u + 1.f/16.f, v + 1.f/16.f, 32, 32);
+}
+
+struct WidgetCase
+{
+    const char* name;
+    void (*call)(int i);
+    int batch;                  // Calls per frame, small enough to fit the area and queue.
+    bool inScrollArea;
+};
+
+static const WidgetCase g_cases[] =
+{
+    { "imguiButton", callButton, 64, true },
+    { "imguiButton disabled", callButtonDisabled, 64, true },
+    { "imguiItem", callItem, 64, true },
+    { "imguiCheck", callCheck, 64, true },
+    { "imguiCollapse", callCollapse, 64, true },
+    { "imguiLabel", callLabel, 64, true },
+    { "imguiValue", callValue, 64, true },
+    { "imguiParagraph", callParagraph, 32, true },
+    { "imguiSlider", callSlider, 64, true },
+    { "imguiSeparator", callSeparator, 64, true },
+    { "imguiSeparatorLine", callSeparatorLine, 64, true },
+    { "imguiIndent+Unindent", callIndent, 64, true },
+    { "imguiPlot", callPlot, 16, true },
+    { "imguiPlot area", callPlotArea, 8, true },
+    { "imguiImage", callImage, 64, true },
+    { "imguiBeginScrollArea+End", callScrollArea, 64, false },
+    { "imguiDrawText", callDrawText, 64, false },
+    { "imguiDrawLine", callDrawLine, 64, false },
+    { "imguiDrawPolyline", callDrawPolyline, 64, false },
+    { "imguiDrawRect", callDrawRect, 64, false },
+    { "imguiDrawRoundedRect", callDrawRoundedRect, 64, false },
+    { "imguiDrawCircle", callDrawCircle, 64, false },
+    { "imguiDrawEllipse ring", callDrawEllipseRing, 64, false },
+    { "imguiDrawMarkers x256", callDrawMarkers, 16, false },
+};
+static const int CASE_COUNT = (int)(sizeof(g_cases)/sizeof(g_cases[0]));
+
+struct WidgetResult
+{
+    double ns;
+    double commands;
+    double textBytes;
+    double points;
+    int dropped;
+};
+
+static void runCase(const WidgetCase& c, int calls, WidgetResult& r)
+{
+    memset(&r, 0, sizeof(r));
+    long long ns = 0, commands = 0, textBytes = 0, points = 0;
+    for (int done = 0; done < calls; )
+    {
+        const int n = calls - done < c.batch ? calls - done : c.batch;
+
+        // Mouse outside every widget so nothing goes hot.
+        imguiBeginFrame(-100, -100, 0, 0);
+        if (c.inScrollArea)
+            imguiBeginScrollArea("Bench", 0, 0, AREA_WIDTH, AREA_HEIGHT, &g_scroll);
+
+        const int q0 = imguiGetRenderQueueSize();
+        const int t0 = imguiGetTextPoolSize();
+        const int p0 = imguiGetPointPoolSize();
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < n; ++i)
+            c.call(done + i);
+        const Clock::time_point end = Clock::now();
+        ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+        commands += imguiGetRenderQueueSize() - q0;
+        textBytes += imguiGetTextPoolSize() - t0;
+        points += imguiGetPointPoolSize() - p0;
+
+        if (c.inScrollArea)
+            imguiEndScrollArea();
+        imguiEndFrame();
+        const imguiFrameStats* stats = imguiGetFrameStats();
+        r.dropped += stats->droppedCommands + stats->droppedTextBytes + stats->droppedPoints + stats->droppedLines;
+        done += n;
+    }
+    r.ns = (double)ns / calls;
+    r.commands = (double)commands / calls;
+    r.textBytes = (double)textBytes / calls;
+    r.points = (double)points / calls;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+enum CommandKind
+{
+    KIND_RECT,
+    KIND_ROUNDED_RECT,
+    KIND_TRIANGLE,
+    KIND_LINE,
+    KIND_TEXT,
+    KIND_SCISSOR,
+    KIND_POLYLINE,
+    KIND_BAND,
+    KIND_ELLIPSE,
+    KIND_MARKERS,
+    KIND_IMAGE,
+    KIND_COUNT,
+};
+
+static const char* g_kindNames[KIND_COUNT] =
+{
+    "rect", "rounded rect", "triangle", "line", "text", "scissor", "polyline", "band", "ellipse", "markers", "image",
+};
+
+static int commandKind(const imguiGfxCmd& cmd)
+{
+    switch (cmd.type)
+    {
+    case IMGUI_GFXCMD_RECT: return cmd.rect.r ? KIND_ROUNDED_RECT : KIND_RECT;
+    case IMGUI_GFXCMD_TRIANGLE: return KIND_TRIANGLE;
+    case IMGUI_GFXCMD_LINE: return KIND_LINE;
+    case IMGUI_GFXCMD_TEXT: return KIND_TEXT;
+    case IMGUI_GFXCMD_SCISSOR: return KIND_SCISSOR;
+    case IMGUI_GFXCMD_POLYLINE:
+        if (cmd.flags & IMGUI_POLYLINE_MARKERS)
+            return KIND_MARKERS;
+        return (cmd.flags & IMGUI_POLYLINE_BAND) ? KIND_BAND : KIND_POLYLINE;
+    case IMGUI_GFXCMD_ELLIPSE: return KIND_ELLIPSE;
+    case IMGUI_GFXCMD_IMAGE: return KIND_IMAGE;
+    }
+    return -1;
+}
+
+struct TessResult
+{
+    int count;                  // Commands of this kind in the sample frame.
+    double ns;
+    double vertices;
+    double indices;
+    double drawCmds;
+};
+
+// Builds one frame with every widget and draw call, then tessellates the
+// commands of each kind on their own. The frame stays current so text and
+// point pointers remain valid.
+static void runTessellation(int calls, TessResult* results)
+{
+    imguiBeginFrame(-100, -100, 0, 0);
+    imguiBeginScrollArea("Bench", 0, 0, AREA_WIDTH, AREA_HEIGHT, &g_scroll);
+    for (int c = 0; c < CASE_COUNT; ++c)
+        if (g_cases[c].inScrollArea)
+            for (int i = 0; i < 4; ++i)
+                g_cases[c].call(i);
+    imguiEndScrollArea();
+    for (int c = 0; c < CASE_COUNT; ++c)
+        if (!g_cases[c].inScrollArea)
+            for (int i = 0; i < 16; ++i)
+                g_cases[c].call(i);
+    imguiEndFrame();
+
+    const imguiGfxCmd* q = imguiGetRenderQueue();
+    const int nq = imguiGetRenderQueueSize();
+    std::vector<imguiGfxCmd> cmds;
+    cmds.reserve(nq);
+    imguiDrawList list;
+
+    for (int k = 0; k < KIND_COUNT; ++k)
+    {
+        TessResult& r = results[k];
+        memset(&r, 0, sizeof(r));
+        cmds.clear();
+        for (int i = 0; i < nq; ++i)
+            if (commandKind(q[i]) == k)
+                cmds.push_back(q[i]);
+        r.count = (int)cmds.size();
+        if (cmds.empty())
+            continue;
+
+        const int n = (int)cmds.size();
+        const int repeat = (calls + n-1) / n;
+        imguiTessellate(&list, &cmds[0], n);
+        const Clock::time_point start = Clock::now();
+        for (int i = 0; i < repeat; ++i)
+            imguiTessellate(&list, &cmds[0], n);
+        const Clock::time_point end = Clock::now();
+
+        const double total = (double)repeat * n;
+        r.ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / total;
+        r.vertices = (double)list.vertexCount / n;
+        r.indices = (double)list.indexCount / n;
+        r.drawCmds = (double)list.cmdCount / n;
+    }
+    imguiTessFreeDrawList(&list);
+}
+
+static bool loadFile(const char* path, std::string& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        data.append(buf, n);
+    fclose(fp);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int calls = 20000;
+    bool json = false;
+    const char* font = "DroidSans.ttf";
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--json") == 0) json = true;
+        else if (strcmp(argv[i], "--calls") == 0 && i+1 < argc) calls = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--font") == 0 && i+1 < argc) font = argv[++i];
+        else
+        {
+            fprintf(stderr, "usage: %s [--calls N] [--font path] [--json]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    if (calls < 1)
+        calls = 1;
+
+    for (int i = 0; i < PLOT_SAMPLES; ++i)
+        g_plotValues[i] = (float)((i*7919) % 2001 - 1000) / 1000.f;
+
+    // Text is measured with the font's advances and tessellated with its
+    // glyphs. Without a font, text uses default advances and tessellates
+    // to nothing.
+    std::string ttf;
+    static unsigned char fontBitmap[512*512];
+    const bool hasFont = loadFile(font, ttf) && imguiTessInit((const unsigned char*)ttf.data(), fontBitmap, 512, 512);
+    if (!hasFont)
+    {
+        imguiTessInit(0, 0, 0, 0);
+        fprintf(stderr, "Could not load font '%s', text is not tessellated.\n", font);
+    }
+
+    WidgetResult widgets[CASE_COUNT];
+    for (int c = 0; c < CASE_COUNT; ++c)
+    {
+        // Warm up caches such as paragraph layouts first.
+        runCase(g_cases[c], g_cases[c].batch, widgets[c]);
+        runCase(g_cases[c], calls, widgets[c]);
+    }
+    TessResult tess[KIND_COUNT];
+    runTessellation(calls, tess);
+
+    const double cmdSize = (double)sizeof(imguiGfxCmd);
+    if (json)
+    {
+        printf("{\"calls\": %d, \"widgets\": [", calls);
+        for (int c = 0; c < CASE_COUNT; ++c)
+        {
+            const WidgetResult& r = widgets[c];
+            printf("%s\n  {\"name\": \"%s\", \"ns_per_call\": %.1f, \"commands_per_call\": %.2f, "
+                   "\"queue_bytes_per_call\": %.1f, \"text_bytes_per_call\": %.1f, \"point_bytes_per_call\": %.1f, \"dropped\": %d}",
+                   c ? "," : "", g_cases[c].name, r.ns, r.commands, r.commands*cmdSize, r.textBytes, r.points*4, r.dropped);
+        }
+        printf("\n], \"tessellation\": [");
+        bool first = true;
+        for (int k = 0; k < KIND_COUNT; ++k)
+        {
+            const TessResult& r = tess[k];
+            if (!r.count)
+                continue;
+            printf("%s\n  {\"command\": \"%s\", \"ns_per_command\": %.1f, \"vertices_per_command\": %.1f, "
+                   "\"indices_per_command\": %.1f, \"draws_per_command\": %.3f}",
+                   first ? "" : ",", g_kindNames[k], r.ns, r.vertices, r.indices, r.drawCmds);
+            first = false;
+        }
+        printf("\n]}\n");
+    }
+    else
+    {
+        printf("%-26s %9s %9s %9s %9s %9s\n", "widget", "ns/call", "cmds", "queue B", "text B", "point B");
+        for (int c = 0; c < CASE_COUNT; ++c)
+        {
+            const WidgetResult& r = widgets[c];
+            printf("%-26s %9.1f %9.2f %9.1f %9.1f %9.1f%s\n", g_cases[c].name, r.ns, r.commands,
+                   r.commands*cmdSize, r.textBytes, r.points*4, r.dropped ? "  (dropped output)" : "");
+        }
+        printf("\n%-26s %9s %9s %9s %9s\n", "tessellation", "ns/cmd", "verts", "indices", "draws");
+        for (int k = 0; k < KIND_COUNT; ++k)
+        {
+            const TessResult& r = tess[k];
+            if (r.count)
+                printf("%-26s %9.1f %9.1f %9.1f %9.3f\n", g_kindNames[k], r.ns, r.vertices, r.indices, r.drawCmds);
+        }
+    }
+    return EXIT_SUCCESS;
+}
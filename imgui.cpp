@@ -19,10 +19,15 @@
 // Source altered and distributed from https://github.com/AdrienHerubel/imgui
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <atomic>
+#include <chrono>
 #include "imgui.h"
+#include "imguiInternal.h"
+#include "imguiProfiler.h"
 
 #ifdef _MSC_VER
 #       define snprintf _snprintf
@@ -30,33 +35,132 @@
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+static imguiFrameStats g_frameStats;
+
+static void* defaultRealloc(void* ptr, size_t size, void*)
+{
+        return realloc(ptr, size);
+}
+
+static void defaultFree(void* ptr, void*)
+{
+        free(ptr);
+}
+
+static imguiReallocFunc g_reallocFunc = defaultRealloc;
+static imguiFreeFunc g_freeFunc = defaultFree;
+static void* g_allocUserData = 0;
+
+// Worker threads allocate too, so the counts are atomics, copied into
+// imguiFrameStats by imguiGetFrameStats().
+static std::atomic<int> g_allocations(0);
+static std::atomic<int> g_allocatedBytes(0);
+static std::atomic<int> g_frees(0);
+
+void imguiSetAllocator(imguiReallocFunc reallocFunc, imguiFreeFunc freeFunc, void* userData)
+{
+        g_reallocFunc = reallocFunc ? reallocFunc : defaultRealloc;
+        g_freeFunc = freeFunc ? freeFunc : defaultFree;
+        g_allocUserData = userData;
+}
+
+void* imguiRealloc(void* ptr, size_t size)
+{
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_allocatedBytes.fetch_add((int)size, std::memory_order_relaxed);
+        return g_reallocFunc(ptr, size, g_allocUserData);
+}
+
+void imguiFree(void* ptr)
+{
+        if (!ptr)
+                return;
+        g_frees.fetch_add(1, std::memory_order_relaxed);
+        g_freeFunc(ptr, g_allocUserData);
+}
+
 static const unsigned TEXT_POOL_SIZE = 8000;
-static char g_textPool[TEXT_POOL_SIZE];
+static char g_textPools[2][TEXT_POOL_SIZE];
+static char* g_textPool = g_textPools[0];
 static unsigned g_textPoolSize = 0;
-static const char* allocText(const char* text)
+static const char* allocText(const char* text, unsigned len)
 {
-        unsigned len = strlen(text)+1;
-        if (g_textPoolSize + len >= TEXT_POOL_SIZE)
+        if (g_textPoolSize + len+1 >= TEXT_POOL_SIZE)
+        {
+                g_frameStats.droppedTextBytes += len+1;
                 return 0;
+        }
         char* dst = &g_textPool[g_textPoolSize]; 
         memcpy(dst, text, len);
-        g_textPoolSize += len;
+        dst[len] = '\0';
+        g_textPoolSize += len+1;
         return dst;
 }
 
+// Points of polyline commands, as 8x fixed point x,y pairs.
+static const unsigned POINT_POOL_SIZE = 16384;
+static short g_pointPools[2][POINT_POOL_SIZE*2];
+static short* g_pointPool = g_pointPools[0];
+static unsigned g_pointPoolSize = 0;
+static short* allocPoints(unsigned count)
+{
+        if (g_pointPoolSize + count > POINT_POOL_SIZE)
+        {
+                g_frameStats.droppedPoints += count;
+                return 0;
+        }
+        short* dst = &g_pointPool[g_pointPoolSize*2];
+        g_pointPoolSize += count;
+        return dst;
+}
+
+// The queue and pools are double buffered so the previous frame stays
+// around for damage tracking. g_gfxCmdOwner holds the widget id that was
+// current when each command was added.
 static const unsigned GFXCMD_QUEUE_SIZE = 5000;
-static imguiGfxCmd g_gfxCmdQueue[GFXCMD_QUEUE_SIZE];
+static imguiGfxCmd g_gfxCmdQueues[2][GFXCMD_QUEUE_SIZE];
+static unsigned int g_gfxCmdOwners[2][GFXCMD_QUEUE_SIZE];
+static imguiGfxCmd* g_gfxCmdQueue = g_gfxCmdQueues[0];
+static unsigned int* g_gfxCmdOwner = g_gfxCmdOwners[0];
 static unsigned g_gfxCmdQueueSize = 0;
+static unsigned g_prevGfxCmdQueueSize = 0;
+static unsigned g_queueIndex = 0;
+static bool g_damageValid = false;
+
+static unsigned int currentWidgetId();
 
 static void resetGfxCmdQueue()
 {
+        g_prevGfxCmdQueueSize = g_gfxCmdQueueSize;
+        g_queueIndex ^= 1;
+        g_gfxCmdQueue = g_gfxCmdQueues[g_queueIndex];
+        g_gfxCmdOwner = g_gfxCmdOwners[g_queueIndex];
+        g_textPool = g_textPools[g_queueIndex];
+        g_pointPool = g_pointPools[g_queueIndex];
         g_gfxCmdQueueSize = 0;
         g_textPoolSize = 0;
+        g_pointPoolSize = 0;
+        g_damageValid = false;
+        memset(&g_frameStats, 0, sizeof(g_frameStats));
+        g_allocations.store(0, std::memory_order_relaxed);
+        g_allocatedBytes.store(0, std::memory_order_relaxed);
+        g_frees.store(0, std::memory_order_relaxed);
 }
 
-static void addGfxCmdScissor(int x, int y, int w, int h)
+static bool reserveGfxCmd()
 {
         if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        {
+                g_frameStats.droppedCommands++;
+                return false;
+        }
+        g_gfxCmdOwner[g_gfxCmdQueueSize] = currentWidgetId();
+        return true;
+}
+
+static void addGfxCmdScissor(int x, int y, int w, int h)
+{
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_SCISSOR;
@@ -66,11 +170,12 @@ static void addGfxCmdScissor(int x, int y, int w, int h)
         cmd.rect.y = (short)y;
         cmd.rect.w = (short)w;
         cmd.rect.h = (short)h;
+        cmd.rect.r = 0;
 }
 
 static void addGfxCmdRect(float x, float y, float w, float h, unsigned int color)
 {
-        if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_RECT;
@@ -85,7 +190,7 @@ static void addGfxCmdRect(float x, float y, float w, float h, unsigned int color
 
 static void addGfxCmdLine(float x0, float y0, float x1, float y1, float r, unsigned int color)
 {
-        if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_LINE;
@@ -98,9 +203,24 @@ static void addGfxCmdLine(float x0, float y0, float x1, float y1, float r, unsig
         cmd.line.r = (short)(r*8.0f);
 }
 
+static void addGfxCmdEllipse(float x, float y, float w, float h, float stroke, unsigned int color)
+{
+        if (!reserveGfxCmd())
+                return;
+        imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
+        cmd.type = IMGUI_GFXCMD_ELLIPSE;
+        cmd.flags = 0;
+        cmd.col = color;
+        cmd.rect.x = (short)(x*8.0f);
+        cmd.rect.y = (short)(y*8.0f);
+        cmd.rect.w = (short)(w*8.0f);
+        cmd.rect.h = (short)(h*8.0f);
+        cmd.rect.r = (short)(stroke*8.0f);
+}
+
 static void addGfxCmdRoundedRect(float x, float y, float w, float h, float r, unsigned int color)
 {
-        if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_RECT;
@@ -115,7 +235,7 @@ static void addGfxCmdRoundedRect(float x, float y, float w, float h, float r, un
 
 static void addGfxCmdTriangle(int x, int y, int w, int h, int flags, unsigned int color)
 {
-        if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_TRIANGLE;
@@ -127,9 +247,9 @@ static void addGfxCmdTriangle(int x, int y, int w, int h, int flags, unsigned in
         cmd.rect.h = (short)(h*8.0f);
 }
 
-static void addGfxCmdText(int x, int y, int align, const char* text, unsigned int color)
+static void addGfxCmdText(int x, int y, int align, const char* text, unsigned len, unsigned int color)
 {
-        if (g_gfxCmdQueueSize >= GFXCMD_QUEUE_SIZE)
+        if (!reserveGfxCmd())
                 return;
         imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
         cmd.type = IMGUI_GFXCMD_TEXT;
@@ -138,7 +258,51 @@ static void addGfxCmdText(int x, int y, int align, const char* text, unsigned in
         cmd.text.x = (short)x;
         cmd.text.y = (short)y;
         cmd.text.align = (short)align;
-        cmd.text.text = allocText(text);
+        cmd.text.text = allocText(text, len);
+}
+
+static void addGfxCmdText(int x, int y, int align, const char* text, unsigned int color)
+{
+        addGfxCmdText(x, y, align, text, strlen(text), color);
+}
+
+static void addGfxCmdPolyline(const short* points, unsigned count, float r, int flags, unsigned int color)
+{
+        if (!reserveGfxCmd())
+                return;
+        imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
+        cmd.type = IMGUI_GFXCMD_POLYLINE;
+        cmd.flags = (char)flags;
+        cmd.col = color;
+        cmd.poly.count = (unsigned short)count;
+        cmd.poly.r = (short)(r*8.0f);
+        cmd.poly.points = points;
+}
+
+inline unsigned short unorm16(float v)
+{
+        if (!(v > 0.0f)) return 0;
+        if (v >= 1.0f) return 0xffff;
+        return (unsigned short)(v*65535.0f + 0.5f);
+}
+
+static void addGfxCmdImage(float x, float y, float w, float h, unsigned int texture,
+                           float u0, float v0, float u1, float v1)
+{
+        if (!reserveGfxCmd())
+                return;
+        imguiGfxCmd& cmd = g_gfxCmdQueue[g_gfxCmdQueueSize++];
+        cmd.type = IMGUI_GFXCMD_IMAGE;
+        cmd.flags = 0;
+        cmd.col = texture;
+        cmd.image.x = (short)(x*8.0f);
+        cmd.image.y = (short)(y*8.0f);
+        cmd.image.w = (short)(w*8.0f);
+        cmd.image.h = (short)(h*8.0f);
+        cmd.image.u0 = unorm16(u0);
+        cmd.image.v0 = unorm16(v0);
+        cmd.image.u1 = unorm16(u1);
+        cmd.image.v1 = unorm16(v1);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -149,7 +313,8 @@ struct GuiState
                 mx(-1), my(-1), scroll(0),
                 active(0), hot(0), hotToBe(0), isHot(false), isActive(false), wentActive(false),
                 dragX(0), dragY(0), dragOrig(0), widgetX(0), widgetY(0), widgetW(100),
-                insideCurrentScroll(false),  areaId(0), widgetId(0)
+                insideCurrentScroll(false),  areaId(0), widgetId(0),
+                changed(true), frameActive(0)
         {
         }
 
@@ -170,9 +335,21 @@ struct GuiState
         
         unsigned int areaId;
         unsigned int widgetId;
+
+        // Set when input or widget state changed in a way that affects this
+        // or the next frame.
+        bool changed;
+        unsigned int frameActive;
 };
 
 static GuiState g_state;
+static unsigned int g_frame = 0;
+static std::chrono::steady_clock::time_point g_frameStart;
+
+static unsigned int currentWidgetId()
+{
+        return (g_state.areaId<<16) | g_state.widgetId;
+}
 
 inline bool anyActive()
 {
@@ -256,6 +433,8 @@ static void updateInput(int mx, int my, unsigned char mbut, int scroll)
 {
         bool left = (mbut & IMGUI_MBUT_LEFT) != 0;
 
+        g_state.changed = mx != g_state.mx || my != g_state.my || left != g_state.left || scroll != 0;
+
         g_state.mx = mx;
         g_state.my = my;
         g_state.leftPressed = !g_state.left && left;
@@ -267,10 +446,12 @@ static void updateInput(int mx, int my, unsigned char mbut, int scroll)
 
 void imguiBeginFrame(int mx, int my, unsigned char mbut, int scroll)
 {
+        IMGUI_PROFILE_BEGIN("imguiBeginFrame");
         updateInput(mx,my,mbut,scroll);
 
         g_state.hot = g_state.hotToBe;
         g_state.hotToBe = 0;
+        g_state.frameActive = g_state.active;
 
         g_state.wentActive = false;
         g_state.isActive = false;
@@ -283,12 +464,21 @@ void imguiBeginFrame(int mx, int my, unsigned char mbut, int scroll)
         g_state.areaId = 1;
         g_state.widgetId = 1;
 
+        g_frame++;
+
         resetGfxCmdQueue();
+        g_frameStart = std::chrono::steady_clock::now();
+        IMGUI_PROFILE_END();
+        IMGUI_PROFILE_BEGIN("imguiFrame");
 }
 
 void imguiEndFrame()
 {
+        IMGUI_PROFILE_BEGIN("imguiEndFrame");
         clearInput();
+        g_frameStats.buildTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - g_frameStart).count();
+        IMGUI_PROFILE_END();
+        IMGUI_PROFILE_END();
 }
 
 const imguiGfxCmd* imguiGetRenderQueue()
@@ -301,6 +491,85 @@ int imguiGetRenderQueueSize()
         return g_gfxCmdQueueSize;
 }
 
+const char* imguiGetTextPool()
+{
+        return g_textPool;
+}
+
+int imguiGetTextPoolSize()
+{
+        return g_textPoolSize;
+}
+
+const short* imguiGetPointPool()
+{
+        return g_pointPool;
+}
+
+int imguiGetPointPoolSize()
+{
+        return g_pointPoolSize;
+}
+
+imguiFrameStats* imguiGetFrameStats()
+{
+        for (int i = 0; i < IMGUI_GFXCMD_COUNT; ++i)
+                g_frameStats.commands[i] = 0;
+        for (unsigned i = 0; i < g_gfxCmdQueueSize; ++i)
+                if (g_gfxCmdQueue[i].type >= 0 && g_gfxCmdQueue[i].type < IMGUI_GFXCMD_COUNT)
+                        g_frameStats.commands[(int)g_gfxCmdQueue[i].type]++;
+        g_frameStats.textBytes = (int)g_textPoolSize;
+        g_frameStats.points = (int)g_pointPoolSize;
+        g_frameStats.allocations = g_allocations.load(std::memory_order_relaxed);
+        g_frameStats.allocatedBytes = g_allocatedBytes.load(std::memory_order_relaxed);
+        g_frameStats.frees = g_frees.load(std::memory_order_relaxed);
+        return &g_frameStats;
+}
+
+void imguiSetRenderQueue(const imguiGfxCmd* cmds, int count, const char* text, int textSize,
+                         const short* points, int pointCount)
+{
+        resetGfxCmdQueue();
+
+        if (count > (int)GFXCMD_QUEUE_SIZE) count = (int)GFXCMD_QUEUE_SIZE;
+        if (textSize > (int)TEXT_POOL_SIZE) textSize = (int)TEXT_POOL_SIZE;
+        if (pointCount > (int)POINT_POOL_SIZE) pointCount = (int)POINT_POOL_SIZE;
+        if (!points) pointCount = 0;
+        if (count > 0)
+                memcpy(g_gfxCmdQueue, cmds, count*sizeof(imguiGfxCmd));
+        memset(g_gfxCmdOwner, 0, count > 0 ? count*sizeof(unsigned int) : 0);
+        if (textSize > 0)
+        {
+                memcpy(g_textPool, text, textSize);
+                // Keeps the last string terminated when the pool was cut short.
+                g_textPool[textSize-1] = '\0';
+        }
+        if (pointCount > 0)
+                memcpy(g_pointPool, points, pointCount*2*sizeof(short));
+        g_gfxCmdQueueSize = count;
+        g_textPoolSize = textSize;
+        g_pointPoolSize = pointCount;
+
+        // Rebase text and point pointers into the pools.
+        for (int i = 0; i < count; ++i)
+        {
+                imguiGfxCmd& cmd = g_gfxCmdQueue[i];
+                if (cmd.type == IMGUI_GFXCMD_TEXT && cmd.text.text)
+                {
+                        const int offset = (int)(cmd.text.text - text);
+                        cmd.text.text = offset >= 0 && offset < textSize ? g_textPool + offset : 0;
+                }
+                else if (cmd.type == IMGUI_GFXCMD_POLYLINE && cmd.poly.points)
+                {
+                        const int first = points ? (int)(cmd.poly.points - points)/2 : -1;
+                        const bool valid = first >= 0 && first + (int)cmd.poly.count <= pointCount;
+                        cmd.poly.points = valid ? g_pointPool + first*2 : 0;
+                        if (!valid)
+                                cmd.poly.count = 0;
+                }
+        }
+}
+
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 static const int BUTTON_HEIGHT = 20;
@@ -312,6 +581,7 @@ static const int TEXT_HEIGHT = 8;
 static const int SCROLL_AREA_PADDING = 6;
 static const int INDENT_SIZE = 16;
 static const int AREA_HEADER = 28;
+static const int LINE_HEIGHT = 16;
 
 static int g_scrollTop = 0;
 static int g_scrollBottom = 0;
@@ -325,6 +595,7 @@ static bool g_insideScrollArea = false;
 
 bool imguiBeginScrollArea(const char* name, int x, int y, int w, int h, int* scroll)
 {
+        IMGUI_PROFILE_BEGIN("imguiScrollArea");
         g_state.areaId++;
         g_state.widgetId = 0;
         g_scrollId = (g_state.areaId<<16) | g_state.widgetId;
@@ -400,7 +671,10 @@ void imguiEndScrollArea()
                                 u = g_state.dragOrig + (g_state.my - g_state.dragY) / (float)range;
                                 if (u < 0) u = 0;
                                 if (u > 1) u = 1;
-                                *g_scrollVal = (int)((1-u) * (sh - h));
+                                const int val = (int)((1-u) * (sh - h));
+                                if (val != *g_scrollVal)
+                                        g_state.changed = true;
+                                *g_scrollVal = val;
                         }
                 }
                 
@@ -417,13 +691,17 @@ void imguiEndScrollArea()
                 {
                         if (g_state.scroll)
                         {
+                                const int val = *g_scrollVal;
                                 *g_scrollVal += 20*g_state.scroll;
                                 if (*g_scrollVal < 0) *g_scrollVal = 0;
                                 if (*g_scrollVal > (sh - h)) *g_scrollVal = (sh - h);
+                                if (val != *g_scrollVal)
+                                        g_state.changed = true;
                         }
                 }
         }
         g_state.insideCurrentScroll = false;
+        IMGUI_PROFILE_END();
 }
 
 bool imguiButton(const char* text, bool enabled)
@@ -548,6 +826,219 @@ void imguiLabel(const char* text)
         addGfxCmdText(x, y+BUTTON_HEIGHT/2-TEXT_HEIGHT/2, IMGUI_ALIGN_LEFT, text, imguiRGBA(255,255,255,255));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Wrapped text. Line breaks are cached per widget and only recomputed when
+// the text hash or the available width changes.
+
+static const float DEFAULT_CHAR_ADVANCE = 7.0f;
+static float g_charAdvance[128];
+
+void imguiSetCharAdvances(const float* advances, int first, int count)
+{
+        for (int i = 0; i < count; ++i)
+        {
+                if (first+i >= 0 && first+i < 128)
+                        g_charAdvance[first+i] = advances[i];
+        }
+}
+
+inline float charAdvance(unsigned char c)
+{
+        if (c < 128 && g_charAdvance[c] > 0)
+                return g_charAdvance[c];
+        return DEFAULT_CHAR_ADVANCE;
+}
+
+// Glyphs for imguiTextWidth() from the advances alone.
+struct AdvanceGlyphs
+{
+        float place(unsigned char c, float x, float& right) const
+        {
+                const float advance = charAdvance(c);
+                right = x + advance;
+                return advance;
+        }
+};
+
+static const unsigned int FNV_OFFSET = 2166136261u;
+static const unsigned int FNV_PRIME = 16777619u;
+
+static const unsigned PARAGRAPH_CACHE_SIZE = 32;
+static const unsigned PARAGRAPH_MAX_LINES = 256;
+
+struct ParagraphLayout
+{
+        unsigned int id;
+        unsigned int frame;
+        int width;
+        unsigned int hash;      // Hash of the whole text.
+        unsigned int len;
+        unsigned int tailHash;  // Hash of the text up to tailEnd.
+        unsigned tailEnd;       // End of the first word of the last line.
+        unsigned lineCount;
+        unsigned dropped;       // Lines past PARAGRAPH_MAX_LINES.
+        unsigned lineStart[PARAGRAPH_MAX_LINES];
+        unsigned lineEnd[PARAGRAPH_MAX_LINES];
+};
+
+static ParagraphLayout g_paragraphs[PARAGRAPH_CACHE_SIZE];
+
+static ParagraphLayout* getParagraphLayout(unsigned int id)
+{
+        ParagraphLayout* oldest = &g_paragraphs[0];
+        for (unsigned i = 0; i < PARAGRAPH_CACHE_SIZE; ++i)
+        {
+                ParagraphLayout* p = &g_paragraphs[i];
+                if (p->id == id && p->lineCount > 0)
+                        return p;
+                if (p->frame < oldest->frame)
+                        oldest = p;
+        }
+        oldest->id = id;
+        oldest->width = -1;
+        oldest->lineCount = 0;
+        oldest->dropped = 0;
+        return oldest;
+}
+
+static void addParagraphLine(ParagraphLayout* p, unsigned start, unsigned end)
+{
+        if (p->lineCount >= PARAGRAPH_MAX_LINES)
+        {
+                p->dropped++;
+                return;
+        }
+        p->lineStart[p->lineCount] = start;
+        p->lineEnd[p->lineCount] = end;
+        p->lineCount++;
+}
+
+// Breaks text into lines starting at offset i, appending to the layout.
+static void wrapParagraph(ParagraphLayout* p, const char* text, unsigned i, int width)
+{
+        const unsigned NO_BREAK = ~0u;
+        unsigned start = i;
+        unsigned lastBreak = NO_BREAK;
+        float lineWidth = 0;
+        while (text[i])
+        {
+                unsigned char c = (unsigned char)text[i];
+                if (c == '\n')
+                {
+                        addParagraphLine(p, start, i);
+                        start = ++i;
+                        lastBreak = NO_BREAK;
+                        lineWidth = 0;
+                        continue;
+                }
+                const float adv = charAdvance(c);
+                if (lineWidth + adv > width && i > start && c != ' ')
+                {
+                        if (lastBreak != NO_BREAK)
+                        {
+                                addParagraphLine(p, start, lastBreak);
+                                i = lastBreak+1;
+                        }
+                        else
+                        {
+                                addParagraphLine(p, start, i);
+                        }
+                        while (text[i] == ' ')
+                                ++i;
+                        start = i;
+                        lastBreak = NO_BREAK;
+                        lineWidth = 0;
+                        continue;
+                }
+                if (c == ' ')
+                        lastBreak = i;
+                lineWidth += adv;
+                ++i;
+        }
+        addParagraphLine(p, start, i);
+}
+
+void imguiParagraph(const char* text)
+{
+        g_state.widgetId++;
+        unsigned int id = (g_state.areaId<<16) | g_state.widgetId;
+
+        const int x = g_state.widgetX;
+        const int w = g_state.widgetW;
+
+        ParagraphLayout* p = getParagraphLayout(id);
+        p->frame = g_frame;
+
+        // Hash the text, remembering the hash up to the end of the first
+        // word of the last line. The break before the last line depends on
+        // nothing past that word, so while it is unchanged only the last
+        // line needs rewrapping.
+        const unsigned tailStart = p->lineCount > 0 ? p->lineStart[p->lineCount-1] : 0;
+        const unsigned tailEnd = p->lineCount > 0 ? p->tailEnd : 0;
+        unsigned int hash = FNV_OFFSET;
+        unsigned int tailHash = FNV_OFFSET;
+        unsigned len = 0;
+        for (; text[len]; ++len)
+        {
+                if (len == tailEnd)
+                        tailHash = hash;
+                hash = (hash ^ (unsigned char)text[len]) * FNV_PRIME;
+        }
+        if (len == tailEnd)
+                tailHash = hash;
+
+        bool relayout = true;
+        if (p->width != w || len < tailEnd || tailHash != p->tailHash)
+        {
+                p->lineCount = 0;
+                p->dropped = 0;
+                wrapParagraph(p, text, 0, w);
+        }
+        else if (hash != p->hash || len != p->len)
+        {
+                p->lineCount--;
+                p->dropped = 0;
+                wrapParagraph(p, text, tailStart, w);
+        }
+        else
+        {
+                relayout = false;
+        }
+
+        if (relayout)
+        {
+                unsigned newTail = p->lineStart[p->lineCount-1];
+                while (text[newTail] && text[newTail] != ' ' && text[newTail] != '\n')
+                        ++newTail;
+                unsigned int h = FNV_OFFSET;
+                for (unsigned i = 0; i < newTail; ++i)
+                        h = (h ^ (unsigned char)text[i]) * FNV_PRIME;
+                p->tailHash = h;
+                p->tailEnd = newTail;
+                p->hash = hash;
+                p->len = len;
+                p->width = w;
+        }
+
+        g_frameStats.droppedLines += (int)p->dropped;
+
+        // Emit only the lines inside the scroll area.
+        const int top = g_state.widgetY;
+        const int height = (int)p->lineCount * LINE_HEIGHT;
+        g_state.widgetY -= height + DEFAULT_SPACING;
+
+        int first = (top - g_scrollTop) / LINE_HEIGHT;
+        int last = (top - g_scrollBottom) / LINE_HEIGHT + 1;
+        if (first < 0) first = 0;
+        if (last > (int)p->lineCount) last = (int)p->lineCount;
+        for (int i = first; i < last; ++i)
+        {
+                const int y = top - (i+1)*LINE_HEIGHT;
+                addGfxCmdText(x, y+LINE_HEIGHT/2-TEXT_HEIGHT/2, IMGUI_ALIGN_LEFT, text + p->lineStart[i],
+                              p->lineEnd[i] - p->lineStart[i], imguiRGBA(255,255,255,200));
+        }
+}
+
 void imguiValue(const char* text)
 {
         const int x = g_state.widgetX;
@@ -628,6 +1119,154 @@ bool imguiSlider(const char* text, float* val, float vmin, float vmax, float vin
 }
 
 
+static const int PLOT_PADDING = 2;
+
+inline void setPoint(short* p, float x, float y)
+{
+        p[0] = (short)(x*8.0f);
+        p[1] = (short)(y*8.0f);
+}
+
+void imguiPlot(const char* text, const float* values, int count, float vmin, float vmax, int height, int flags)
+{
+        g_state.widgetId++;
+
+        const int x = g_state.widgetX;
+        const int y = g_state.widgetY - height;
+        const int w = g_state.widgetW;
+        const int h = height;
+        g_state.widgetY -= height + DEFAULT_SPACING;
+
+        if (y > g_scrollTop || y+h < g_scrollBottom)
+                return;
+
+        addGfxCmdRoundedRect((float)x, (float)y, (float)w, (float)h, 4.0f, imguiRGBA(0,0,0,128));
+
+        const float px = (float)(x + PLOT_PADDING);
+        const float py = (float)(y + PLOT_PADDING);
+        const int pw = w - PLOT_PADDING*2;
+        const float ph = (float)(h - PLOT_PADDING*2);
+        if (values && count > 0 && pw > 0 && ph > 0 && vmax != vmin)
+        {
+                // One sample per point when they fit, otherwise the min and
+                // max of each pixel column in the order they occur, so the
+                // line still reaches every peak.
+                const unsigned columns = (unsigned)pw;
+                const unsigned samples = (unsigned)count;
+                const bool decimate = samples > columns;
+                const unsigned slots = decimate ? columns : samples;
+                const float scale = ph / (vmax - vmin);
+
+                // Band and line come from one allocation, so a full pool
+                // leaves nothing behind. The line is last and gets trimmed.
+                const unsigned bandPoints = (flags & IMGUI_PLOT_AREA) ? slots*2 : 0;
+                short* band = allocPoints(bandPoints + slots*2);
+                short* line = band ? band + bandPoints*2 : 0;
+                if (!bandPoints)
+                        band = 0;
+                unsigned n = 0;
+                for (unsigned c = 0; line && c < slots; ++c)
+                {
+                        unsigned first = c, last = c+1;
+                        float cx = samples > 1 ? px + (float)c*(float)pw/(float)(samples-1) : px + (float)pw*0.5f;
+                        if (decimate)
+                        {
+                                first = (unsigned)((unsigned long long)c*samples/columns);
+                                last = (unsigned)((unsigned long long)(c+1)*samples/columns);
+                                cx = px + (float)c + 0.5f;
+                        }
+                        float lo = values[first], hi = lo;
+                        unsigned loAt = first, hiAt = first;
+                        for (unsigned i = first+1; i < last; ++i)
+                        {
+                                const float v = values[i];
+                                if (v < lo) { lo = v; loAt = i; }
+                                if (v > hi) { hi = v; hiAt = i; }
+                        }
+
+                        float ylo = (lo - vmin)*scale;
+                        float yhi = (hi - vmin)*scale;
+                        if (!(ylo >= 0)) ylo = 0;
+                        if (ylo > ph) ylo = ph;
+                        if (!(yhi >= 0)) yhi = 0;
+                        if (yhi > ph) yhi = ph;
+                        ylo += py;
+                        yhi += py;
+
+                        if (band)
+                        {
+                                setPoint(band + c*4, cx, py);
+                                setPoint(band + c*4+2, cx, yhi);
+                        }
+                        if (ylo == yhi)
+                        {
+                                setPoint(line + n*2, cx, ylo);
+                                n++;
+                        }
+                        else
+                        {
+                                setPoint(line + n*2, cx, loAt < hiAt ? ylo : yhi);
+                                setPoint(line + n*2+2, cx, loAt < hiAt ? yhi : ylo);
+                                n += 2;
+                        }
+                }
+                if (line)
+                        g_pointPoolSize -= slots*2 - n;
+
+                if (band && slots > 1)
+                        addGfxCmdPolyline(band, slots*2, 1.0f, IMGUI_POLYLINE_BAND, imguiRGBA(255,196,0,64));
+                if (n > 1)
+                        addGfxCmdPolyline(line, n, 1.0f, 0, imguiRGBA(255,196,0,255));
+        }
+
+        addGfxCmdText(x+SLIDER_HEIGHT/2, y+h-SLIDER_HEIGHT/2-TEXT_HEIGHT/2, IMGUI_ALIGN_LEFT, text, imguiRGBA(255,255,255,200));
+}
+
+// Image rows. An image continues the row of the previous one when no other
+// widget came in between and it still fits in the widget width.
+static unsigned int g_imageRowNext = 0;
+static unsigned int g_imageRowFrame = 0;
+static int g_imageRowLeft = 0;
+static int g_imageRowX = 0;
+static int g_imageRowTop = 0;
+static int g_imageRowBottom = 0;
+
+bool imguiImage(unsigned int texture, float u0, float v0, float u1, float v1, int width, int height)
+{
+        g_state.widgetId++;
+        unsigned int id = (g_state.areaId<<16) | g_state.widgetId;
+
+        if (id != g_imageRowNext || g_frame != g_imageRowFrame || g_state.widgetY != g_imageRowBottom ||
+            g_state.widgetX != g_imageRowLeft || g_imageRowX + width > g_state.widgetX + g_state.widgetW)
+        {
+                g_imageRowLeft = g_state.widgetX;
+                g_imageRowX = g_state.widgetX;
+                g_imageRowTop = g_state.widgetY;
+        }
+        const int x = g_imageRowX;
+        const int y = g_imageRowTop - height;
+        const int w = width;
+        const int h = height;
+        g_imageRowX += width + DEFAULT_SPACING;
+        if (y - DEFAULT_SPACING < g_state.widgetY)
+                g_state.widgetY = y - DEFAULT_SPACING;
+        g_imageRowBottom = g_state.widgetY;
+        g_imageRowNext = id + 1;
+        g_imageRowFrame = g_frame;
+
+        if (y > g_scrollTop || y+h < g_scrollBottom)
+                return false;
+
+        bool over = inRect(x, y, w, h);
+        bool res = buttonLogic(id, over);
+
+        if (isHot(id))
+                addGfxCmdRoundedRect((float)x-2, (float)y-2, (float)w+4, (float)h+4, 2.0f, imguiRGBA(255,196,0,isActive(id)?196:96));
+        addGfxCmdImage((float)x, (float)y, (float)w, (float)h, texture, u0, v0, u1, v1);
+
+        return res;
+}
+
 void imguiIndent()
 {
         g_state.widgetX += INDENT_SIZE;
@@ -666,12 +1305,425 @@ void imguiDrawLine(float x0, float y0, float x1, float y1, float r, unsigned int
         addGfxCmdLine(x0, y0, x1, y1, r, color);
 }
 
+void imguiDrawPolyline(const float* points, int count, float r, unsigned int color, int flags)
+{
+        if (!points || count < 2)
+                return;
+        if (count > 0xffff)
+                count = 0xffff;
+        short* dst = allocPoints((unsigned)count);
+        if (!dst)
+                return;
+        for (int i = 0; i < count*2; ++i)
+                dst[i] = (short)(points[i]*8.0f);
+        addGfxCmdPolyline(dst, (unsigned)count, r, flags & (IMGUI_POLYLINE_CLOSED | IMGUI_POLYLINE_BEVEL), color);
+}
+
+void imguiDrawEllipse(float x, float y, float rx, float ry, unsigned int color, float stroke)
+{
+        addGfxCmdEllipse(x-rx, y-ry, rx*2, ry*2, stroke, color);
+}
+
+void imguiDrawCircle(float x, float y, float radius, unsigned int color, float stroke)
+{
+        addGfxCmdEllipse(x-radius, y-radius, radius*2, radius*2, stroke, color);
+}
+
+void imguiDrawMarkers(const float* centers, int count, float radius, unsigned int color)
+{
+        if (!centers || count < 1)
+                return;
+        if (count > 0xffff)
+                count = 0xffff;
+        short* dst = allocPoints((unsigned)count);
+        if (!dst)
+                return;
+        for (int i = 0; i < count*2; ++i)
+                dst[i] = (short)(centers[i]*8.0f);
+        addGfxCmdPolyline(dst, (unsigned)count, radius, IMGUI_POLYLINE_MARKERS, color);
+}
+
 void imguiDrawRect(float x, float y, float w, float h, unsigned int color)
 {
         addGfxCmdRect(x, y, w, h, color);
 }
 
+void imguiDrawImage(float x, float y, float w, float h, unsigned int texture, float u0, float v0, float u1, float v1)
+{
+        addGfxCmdImage(x, y, w, h, texture, u0, v0, u1, v1);
+}
+
 void imguiDrawRoundedRect(float x, float y, float w, float h, float r, unsigned int color)
 {
         addGfxCmdRoundedRect(x, y, w, h, r, color);
-}
\ No newline at end of file
+}
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Damage tracking. The queue is diffed against the previous frame, commands
+// are matched by position and resynchronised by owner id when widgets appear
+// or disappear, and the bounds of mismatching commands are merged into a few
+// rectangles.
+
+static const unsigned MAX_DAMAGE_RECTS = 16;
+static const unsigned DAMAGE_LOOKAHEAD = 32;
+static imguiDamageRect g_damageRects[MAX_DAMAGE_RECTS];
+static unsigned g_damageRectCount = 0;
+static unsigned g_damageQueueSize = 0;
+
+struct DamageStream
+{
+        const imguiGfxCmd* cmds;
+        const unsigned int* owners;
+        unsigned count;
+        unsigned pos;
+        bool clip;
+        int clipX, clipY, clipW, clipH;
+};
+
+static bool sameCommand(const imguiGfxCmd& a, const imguiGfxCmd& b)
+{
+        if (a.type != b.type || a.flags != b.flags || a.col != b.col)
+                return false;
+        if (a.type == IMGUI_GFXCMD_TEXT)
+        {
+                if (a.text.x != b.text.x || a.text.y != b.text.y || a.text.align != b.text.align)
+                        return false;
+                if (!a.text.text || !b.text.text)
+                        return a.text.text == b.text.text;
+                return strcmp(a.text.text, b.text.text) == 0;
+        }
+        if (a.type == IMGUI_GFXCMD_LINE)
+                return a.line.x0 == b.line.x0 && a.line.y0 == b.line.y0 && a.line.x1 == b.line.x1 &&
+                       a.line.y1 == b.line.y1 && a.line.r == b.line.r;
+        if (a.type == IMGUI_GFXCMD_POLYLINE)
+        {
+                if (a.poly.count != b.poly.count || a.poly.r != b.poly.r)
+                        return false;
+                if (!a.poly.points || !b.poly.points)
+                        return a.poly.points == b.poly.points;
+                return memcmp(a.poly.points, b.poly.points, a.poly.count*2*sizeof(short)) == 0;
+        }
+        if (a.type == IMGUI_GFXCMD_IMAGE)
+                return a.image.x == b.image.x && a.image.y == b.image.y && a.image.w == b.image.w &&
+                       a.image.h == b.image.h && a.image.u0 == b.image.u0 && a.image.v0 == b.image.v0 &&
+                       a.image.u1 == b.image.u1 && a.image.v1 == b.image.v1;
+        if (a.type == IMGUI_GFXCMD_SCISSOR && !a.flags)
+                return true;
+        return a.rect.x == b.rect.x && a.rect.y == b.rect.y && a.rect.w == b.rect.w &&
+               a.rect.h == b.rect.h && ((a.type != IMGUI_GFXCMD_RECT && a.type != IMGUI_GFXCMD_ELLIPSE) || a.rect.r == b.rect.r);
+}
+
+inline int floor8(int v)
+{
+        return v >= 0 ? v/8 : -((-v+7)/8);
+}
+
+inline int ceil8(int v)
+{
+        return -floor8(-v);
+}
+
+static bool pointBounds(const imguiGfxCmd& cmd, unsigned first, unsigned last, imguiDamageRect& r)
+{
+        const short* p = cmd.poly.points;
+        int x0 = p[first*2], y0 = p[first*2+1], x1 = x0, y1 = y0;
+        for (unsigned i = first+1; i < last; ++i)
+        {
+                const int px = p[i*2], py = p[i*2+1];
+                if (px < x0) x0 = px;
+                if (px > x1) x1 = px;
+                if (py < y0) y0 = py;
+                if (py > y1) y1 = py;
+        }
+        // Miters reach 4 half widths of the stroke and its fringe.
+        const int rad = cmd.poly.r*2 + 16;
+        x0 = floor8(x0 - rad);
+        y0 = floor8(y0 - rad);
+        x1 = ceil8(x1 + rad);
+        y1 = ceil8(y1 + rad);
+        r.x = x0 - 1;
+        r.y = y0 - 1;
+        r.w = x1 - x0 + 2;
+        r.h = y1 - y0 + 2;
+        return true;
+}
+
+// Pixel bounds including the anti-aliased fringe.
+static bool commandBounds(const imguiGfxCmd& cmd, imguiDamageRect& r)
+{
+        int x0, y0, x1, y1;
+        if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                if (!cmd.text.text)
+                        return false;
+                const float w = imguiTextWidth(cmd.text.text, AdvanceGlyphs());
+                x0 = cmd.text.x;
+                if (cmd.text.align == IMGUI_ALIGN_CENTER)
+                        x0 -= (int)(w/2);
+                else if (cmd.text.align == IMGUI_ALIGN_RIGHT)
+                        x0 -= (int)w;
+                x1 = x0 + (int)w + 1;
+                y0 = cmd.text.y - TEXT_HEIGHT;
+                y1 = cmd.text.y + LINE_HEIGHT;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_LINE)
+        {
+                const int r = cmd.line.r;
+                x0 = floor8((cmd.line.x0 < cmd.line.x1 ? cmd.line.x0 : cmd.line.x1) - r);
+                y0 = floor8((cmd.line.y0 < cmd.line.y1 ? cmd.line.y0 : cmd.line.y1) - r);
+                x1 = ceil8((cmd.line.x0 > cmd.line.x1 ? cmd.line.x0 : cmd.line.x1) + r);
+                y1 = ceil8((cmd.line.y0 > cmd.line.y1 ? cmd.line.y0 : cmd.line.y1) + r);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+        {
+                if (!cmd.poly.points || !cmd.poly.count)
+                        return false;
+                return pointBounds(cmd, 0, cmd.poly.count, r);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+        {
+                if (!cmd.flags)
+                        return false;
+                r.x = cmd.rect.x;
+                r.y = cmd.rect.y;
+                r.w = cmd.rect.w;
+                r.h = cmd.rect.h;
+                return r.w > 0 && r.h > 0;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                x0 = floor8(cmd.image.x);
+                y0 = floor8(cmd.image.y);
+                x1 = ceil8(cmd.image.x + cmd.image.w);
+                y1 = ceil8(cmd.image.y + cmd.image.h);
+        }
+        else
+        {
+                x0 = floor8(cmd.rect.x);
+                y0 = floor8(cmd.rect.y);
+                x1 = ceil8(cmd.rect.x + cmd.rect.w);
+                y1 = ceil8(cmd.rect.y + cmd.rect.h);
+        }
+        r.x = x0 - 1;
+        r.y = y0 - 1;
+        r.w = x1 - x0 + 2;
+        r.h = y1 - y0 + 2;
+        return true;
+}
+
+static unsigned unionArea(const imguiDamageRect& a, const imguiDamageRect& b)
+{
+        const int x0 = a.x < b.x ? a.x : b.x;
+        const int y0 = a.y < b.y ? a.y : b.y;
+        const int x1 = a.x+a.w > b.x+b.w ? a.x+a.w : b.x+b.w;
+        const int y1 = a.y+a.h > b.y+b.h ? a.y+a.h : b.y+b.h;
+        return (unsigned)(x1-x0) * (unsigned)(y1-y0);
+}
+
+static void mergeRect(imguiDamageRect& a, const imguiDamageRect& b)
+{
+        const int x1 = a.x+a.w > b.x+b.w ? a.x+a.w : b.x+b.w;
+        const int y1 = a.y+a.h > b.y+b.h ? a.y+a.h : b.y+b.h;
+        if (b.x < a.x) a.x = b.x;
+        if (b.y < a.y) a.y = b.y;
+        a.w = x1 - a.x;
+        a.h = y1 - a.y;
+}
+
+inline bool touches(const imguiDamageRect& a, const imguiDamageRect& b)
+{
+        return a.x <= b.x+b.w && b.x <= a.x+a.w && a.y <= b.y+b.h && b.y <= a.y+a.h;
+}
+
+static void addDamage(imguiDamageRect r)
+{
+        // Fold in every rect the new one touches, then keep the list bounded
+        // by merging with the rect that grows the least.
+        for (unsigned i = 0; i < g_damageRectCount; )
+        {
+                if (touches(r, g_damageRects[i]))
+                {
+                        mergeRect(r, g_damageRects[i]);
+                        g_damageRects[i] = g_damageRects[--g_damageRectCount];
+                        i = 0;
+                        continue;
+                }
+                ++i;
+        }
+        if (g_damageRectCount < MAX_DAMAGE_RECTS)
+        {
+                g_damageRects[g_damageRectCount++] = r;
+                return;
+        }
+        unsigned best = 0, bestArea = 0xffffffff;
+        for (unsigned i = 0; i < g_damageRectCount; ++i)
+        {
+                const unsigned area = unionArea(r, g_damageRects[i]);
+                if (area < bestArea)
+                {
+                        best = i;
+                        bestArea = area;
+                }
+        }
+        mergeRect(g_damageRects[best], r);
+}
+
+static void damageBounds(const DamageStream& s, imguiDamageRect r)
+{
+        const imguiGfxCmd& cmd = s.cmds[s.pos];
+        if (s.clip && cmd.type != IMGUI_GFXCMD_SCISSOR)
+        {
+                const int x1 = r.x+r.w < s.clipX+s.clipW ? r.x+r.w : s.clipX+s.clipW;
+                const int y1 = r.y+r.h < s.clipY+s.clipH ? r.y+r.h : s.clipY+s.clipH;
+                if (r.x < s.clipX) r.x = s.clipX;
+                if (r.y < s.clipY) r.y = s.clipY;
+                r.w = x1 - r.x;
+                r.h = y1 - r.y;
+        }
+        if (r.w > 0 && r.h > 0)
+                addDamage(r);
+}
+
+static void damageCommand(const DamageStream& s)
+{
+        imguiDamageRect r;
+        if (commandBounds(s.cmds[s.pos], r))
+                damageBounds(s, r);
+}
+
+// Polylines that only differ in some points, e.g. a plot with a few new
+// samples, damage the changed span and its neighbouring segments.
+static bool damagePolylineChange(const DamageStream& prev, const DamageStream& cur)
+{
+        const imguiGfxCmd& a = prev.cmds[prev.pos];
+        const imguiGfxCmd& b = cur.cmds[cur.pos];
+        if (a.type != IMGUI_GFXCMD_POLYLINE || b.type != IMGUI_GFXCMD_POLYLINE ||
+            a.flags != b.flags || a.col != b.col || a.poly.r != b.poly.r || a.poly.count != b.poly.count ||
+            !a.poly.points || !b.poly.points || !a.poly.count || (a.flags & IMGUI_POLYLINE_CLOSED))
+                return false;
+
+        const unsigned n = a.poly.count;
+        const unsigned step = (a.flags & IMGUI_POLYLINE_BAND) ? 2 : 1;
+        unsigned first = 0, last = n;
+        while (first < n && a.poly.points[first*2] == b.poly.points[first*2] && a.poly.points[first*2+1] == b.poly.points[first*2+1])
+                first++;
+        while (last > first && a.poly.points[last*2-2] == b.poly.points[last*2-2] && a.poly.points[last*2-1] == b.poly.points[last*2-1])
+                last--;
+        if (first == last)
+                return true;
+        first = first > step ? (first - step) / step * step : 0;
+        last = last + step < n ? (last + step + step-1) / step * step : n;
+
+        imguiDamageRect r;
+        pointBounds(a, first, last, r);
+        damageBounds(prev, r);
+        pointBounds(b, first, last, r);
+        damageBounds(cur, r);
+        return true;
+}
+
+static void advance(DamageStream& s, bool damaged)
+{
+        const imguiGfxCmd& cmd = s.cmds[s.pos];
+        if (damaged)
+                damageCommand(s);
+        if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+        {
+                s.clip = cmd.flags != 0;
+                s.clipX = cmd.rect.x;
+                s.clipY = cmd.rect.y;
+                s.clipW = cmd.rect.w;
+                s.clipH = cmd.rect.h;
+        }
+        s.pos++;
+}
+
+static int findOwner(const DamageStream& s, unsigned int owner)
+{
+        for (unsigned i = s.pos+1; i < s.count && i <= s.pos+DAMAGE_LOOKAHEAD; ++i)
+                if (s.owners[i] == owner)
+                        return (int)(i - s.pos);
+        return -1;
+}
+
+static void computeDamage()
+{
+        DamageStream prev, cur;
+        memset(&prev, 0, sizeof(prev));
+        memset(&cur, 0, sizeof(cur));
+        prev.cmds = g_gfxCmdQueues[g_queueIndex^1];
+        prev.owners = g_gfxCmdOwners[g_queueIndex^1];
+        prev.count = g_prevGfxCmdQueueSize;
+        cur.cmds = g_gfxCmdQueue;
+        cur.owners = g_gfxCmdOwner;
+        cur.count = g_gfxCmdQueueSize;
+
+        g_damageRectCount = 0;
+        while (prev.pos < prev.count && cur.pos < cur.count)
+        {
+                const unsigned int prevOwner = prev.owners[prev.pos];
+                const unsigned int curOwner = cur.owners[cur.pos];
+                if (prevOwner == curOwner)
+                {
+                        bool same = sameCommand(prev.cmds[prev.pos], cur.cmds[cur.pos]);
+                        if (!same && damagePolylineChange(prev, cur))
+                                same = true;
+                        advance(prev, !same);
+                        advance(cur, !same);
+                        continue;
+                }
+
+                // A widget appeared or disappeared, skip ahead in whichever
+                // stream gets back in sync first.
+                const int added = findOwner(cur, prevOwner);
+                const int removed = findOwner(prev, curOwner);
+                if (added > 0 && (removed < 0 || added <= removed))
+                {
+                        for (int i = 0; i < added; ++i)
+                                advance(cur, true);
+                }
+                else if (removed > 0)
+                {
+                        for (int i = 0; i < removed; ++i)
+                                advance(prev, true);
+                }
+                else
+                {
+                        advance(prev, true);
+                        advance(cur, true);
+                }
+        }
+        while (prev.pos < prev.count)
+                advance(prev, true);
+        while (cur.pos < cur.count)
+                advance(cur, true);
+
+        g_damageQueueSize = g_gfxCmdQueueSize;
+        g_damageValid = true;
+}
+
+const imguiDamageRect* imguiGetDamageRects()
+{
+        if (!g_damageValid || g_damageQueueSize != g_gfxCmdQueueSize)
+                computeDamage();
+        return g_damageRects;
+}
+
+int imguiGetDamageRectCount()
+{
+        if (!g_damageValid || g_damageQueueSize != g_gfxCmdQueueSize)
+                computeDamage();
+        return (int)g_damageRectCount;
+}
+
+bool imguiFrameChanged()
+{
+        if (g_state.changed || g_state.active != g_state.frameActive || g_state.hot != g_state.hotToBe)
+                return true;
+        if (g_gfxCmdQueueSize != g_prevGfxCmdQueueSize)
+                return true;
+        const imguiGfxCmd* prev = g_gfxCmdQueues[g_queueIndex^1];
+        for (unsigned i = 0; i < g_gfxCmdQueueSize; ++i)
+                if (!sameCommand(prev[i], g_gfxCmdQueue[i]))
+                        return true;
+        return false;
+}
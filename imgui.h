@@ -22,6 +22,8 @@
 #ifndef IMGUI_H
 #define IMGUI_H
 
+#include <stddef.h>
+
 enum imguiMouseButton
 {
         IMGUI_MBUT_LEFT = 0x01, 
@@ -57,12 +59,49 @@ bool imguiCheck(const char* text, bool checked, bool enabled = true);
 bool imguiCollapse(const char* text, const char* subtext, bool checked, bool enabled = true);
 void imguiLabel(const char* text);
 void imguiValue(const char* text);
+// Wrapped text, laid out again only when the text or width changes. At
+// most 256 lines are kept; the rest are counted in imguiFrameStats::droppedLines.
+void imguiParagraph(const char* text);
 bool imguiSlider(const char* text, float* val, float vmin, float vmax, float vinc, bool enabled = true);
 
+enum imguiPlotFlags
+{
+        IMGUI_PLOT_LINES = 0,
+        IMGUI_PLOT_AREA = 1,
+};
+
+// Plots 'count' samples scaled to [vmin, vmax] in a box 'height' pixels
+// tall. Samples are reduced to the min and max of each pixel column, so the
+// queue and rendering cost depends on the widget width only.
+void imguiPlot(const char* text, const float* values, int count, float vmin, float vmax, int height, int flags = IMGUI_PLOT_LINES);
+
+// Draws the (u0, v0) - (u1, v1) part of a texture, width x height pixels,
+// and returns true when clicked. (u0, v0) is the top left corner, v = 0 the
+// first row of the texture. 'texture' is the renderer's handle, e.g. a GL
+// texture name; 0 and 0xffffffff are reserved. Consecutive images are laid
+// out side by side while they fit in the widget width.
+bool imguiImage(unsigned int texture, float u0, float v0, float u1, float v1, int width, int height);
+
 void imguiDrawText(int x, int y, int align, const char* text, unsigned int color);
 void imguiDrawLine(float x0, float y0, float x1, float y1, float r, unsigned int color);
+// Connected path through 'count' x, y pairs, queued as one command with its
+// points in the point pool. Flags are IMGUI_POLYLINE_CLOSED and _BEVEL.
+void imguiDrawPolyline(const float* points, int count, float r, unsigned int color, int flags = 0);
 void imguiDrawRoundedRect(float x, float y, float w, float h, float r, unsigned int color);
 void imguiDrawRect(float x, float y, float w, float h, unsigned int color);
+void imguiDrawImage(float x, float y, float w, float h, unsigned int texture,
+                    float u0 = 0.f, float v0 = 0.f, float u1 = 1.f, float v1 = 1.f);
+// Filled, or with stroke > 0 the ring between the ellipse and the one
+// 'stroke' smaller.
+void imguiDrawEllipse(float x, float y, float rx, float ry, unsigned int color, float stroke = 0.f);
+void imguiDrawCircle(float x, float y, float radius, unsigned int color, float stroke = 0.f);
+// Filled circles of the same radius and color at 'count' x, y centers, queued
+// as one command with the centers in the point pool. Radii up to half a pixel
+// draw a dot of the anti-aliased fringe alone, faded by the circle's area.
+void imguiDrawMarkers(const float* centers, int count, float radius, unsigned int color);
+
+// Glyph advances used to wrap text in imguiParagraph(), indexed from character 'first'.
+void imguiSetCharAdvances(const float* advances, int first, int count);
 
 // Pull render interface.
 enum imguiGfxCmdType
@@ -72,13 +111,27 @@ enum imguiGfxCmdType
         IMGUI_GFXCMD_LINE,
         IMGUI_GFXCMD_TEXT,
         IMGUI_GFXCMD_SCISSOR,
+        IMGUI_GFXCMD_POLYLINE,
+        IMGUI_GFXCMD_ELLIPSE,
+        IMGUI_GFXCMD_IMAGE,
+        IMGUI_GFXCMD_COUNT,
 };
 
+// Rects, triangles and ellipses. An ellipse fills the rect's inscribed
+// ellipse or, when r > 0, the ring between it and the ellipse r smaller.
 struct imguiGfxRect
 {
         short x,y,w,h,r;
 };
 
+// Textured rect, 8x fixed point like rects. The texture handle is stored in
+// the command's col, the UV rect as 0..65535 for 0..1.
+struct imguiGfxImage
+{
+        short x,y,w,h;
+        unsigned short u0,v0,u1,v1;
+};
+
 struct imguiGfxText
 {
         short x,y,align;
@@ -90,6 +143,26 @@ struct imguiGfxLine
         short x0,y0,x1,y1,r;
 };
 
+// Path through 'count' points stored in the point pool, 8x fixed point like
+// lines. Corners are mitered up to 4 half widths and beveled past that.
+// With IMGUI_POLYLINE_BAND the points are (x, bottom), (x, top) pairs with
+// increasing x, and the area between the two edges is filled. With
+// IMGUI_POLYLINE_MARKERS each point is the center of a circle of radius r.
+struct imguiGfxPolyline
+{
+        unsigned short count;
+        short r;
+        const short* points;
+};
+
+enum imguiGfxPolylineFlags
+{
+        IMGUI_POLYLINE_BAND = 1,
+        IMGUI_POLYLINE_CLOSED = 2,
+        IMGUI_POLYLINE_BEVEL = 4,
+        IMGUI_POLYLINE_MARKERS = 8,
+};
+
 struct imguiGfxCmd
 {
         char type;
@@ -101,11 +174,77 @@ struct imguiGfxCmd
                 imguiGfxLine line;
                 imguiGfxRect rect;
                 imguiGfxText text;
+                imguiGfxPolyline poly;
+                imguiGfxImage image;
         };
 };
 
 const imguiGfxCmd* imguiGetRenderQueue();
 int imguiGetRenderQueueSize();
+const char* imguiGetTextPool();
+int imguiGetTextPoolSize();
+// x,y pairs referenced by polyline commands, size in points.
+const short* imguiGetPointPool();
+int imguiGetPointPoolSize();
+
+struct imguiDamageRect
+{
+        int x, y, w, h;
+};
+
+// Regions of the render queue that differ from the previous frame, in the
+// same pixel space as the queue. Query after imguiEndFrame().
+const imguiDamageRect* imguiGetDamageRects();
+int imguiGetDamageRectCount();
+
+// Work done for the current frame, reset by imguiBeginFrame(). The core
+// fills in the command and text numbers, renderers add theirs when drawing.
+struct imguiFrameStats
+{
+        int commands[IMGUI_GFXCMD_COUNT];
+        int textBytes;
+        int droppedCommands;
+        int droppedTextBytes;
+        int points;
+        int droppedPoints;
+        int droppedLines;       // Paragraph lines past the 256 kept per imguiParagraph().
+        int allocations;        // Calls into the allocator hooks.
+        int allocatedBytes;
+        int frees;
+        int vertices;
+        int indices;
+        int drawCalls;
+        int batchesSaved;       // Draws avoided by reordering, see imguiTessSetReorder().
+        int textureBinds;
+        int scissorChanges;
+        int uploadBytes;        // Vertex, index and per-draw data sent to the GPU.
+        int droppedDraws;       // Image draws of textures not registered with the renderer.
+        float buildTime;        // ms from imguiBeginFrame() to imguiEndFrame().
+        float renderTime;       // ms spent in the renderer's draw call.
+};
+
+imguiFrameStats* imguiGetFrameStats();
+
+// False when the frame looks exactly like the previous one: no input or
+// widget state changes and an identical render queue. Hosts can then skip
+// drawing and presenting. Query after the last draw call of the frame.
+bool imguiFrameChanged();
+
+// Memory hooks. Every heap allocation made by the library and its renderers
+// goes through them. Null restores realloc() and free(). The tiled renderer
+// and the profiler may call them from worker threads, so the hooks must be
+// thread safe. Calls are counted in atomics that imguiGetFrameStats() copies
+// into allocations, allocatedBytes and frees; imguiBeginFrame() resets them.
+typedef void* (*imguiReallocFunc)(void* ptr, size_t size, void* userData);
+typedef void (*imguiFreeFunc)(void* ptr, void* userData);
+void imguiSetAllocator(imguiReallocFunc reallocFunc, imguiFreeFunc freeFunc, void* userData);
+void* imguiRealloc(void* ptr, size_t size);
+void imguiFree(void* ptr);
+
+// Replaces the render queue, e.g. with a captured frame. Text pointers in
+// 'cmds' must point into 'text', polyline points into 'points'.
+void imguiSetRenderQueue(const imguiGfxCmd* cmds, int count, const char* text, int textSize,
+                         const short* points = 0, int pointCount = 0);
 
 
 #endif // IMGUI_H
\ No newline at end of file
@@ -0,0 +1,461 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#       include <io.h>
+#else
+#       include <fcntl.h>
+#       include <sys/mman.h>
+#       include <sys/stat.h>
+#       include <unistd.h>
+#endif
+
+#include "imguiCapture.h"
+#include "imgui.h"
+#include "imguiInternal.h"
+
+static const unsigned int CAPTURE_VERSION = 2;
+static const unsigned HEADER_SIZE = 16;
+static const unsigned FRAME_HEADER_SIZE = 16;
+static const unsigned RECORD_SIZE = 24;
+static const unsigned FOOTER_SIZE = 12;
+static const unsigned int NO_TEXT = 0xffffffff;
+static const unsigned POINT_SIZE = 4;
+
+inline void put16(unsigned char* p, unsigned int v)
+{
+        p[0] = (unsigned char)(v & 0xff);
+        p[1] = (unsigned char)((v >> 8) & 0xff);
+}
+
+inline void put32(unsigned char* p, unsigned int v)
+{
+        put16(p, v & 0xffff);
+        put16(p+2, v >> 16);
+}
+
+inline void put64(unsigned char* p, unsigned long long v)
+{
+        put32(p, (unsigned int)(v & 0xffffffff));
+        put32(p+4, (unsigned int)(v >> 32));
+}
+
+inline unsigned int get16(const unsigned char* p)
+{
+        return p[0] | (p[1] << 8);
+}
+
+inline unsigned int get32(const unsigned char* p)
+{
+        return get16(p) | (get16(p+2) << 16);
+}
+
+inline unsigned long long get64(const unsigned char* p)
+{
+        return get32(p) | ((unsigned long long)get32(p+4) << 32);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static imguiGfxCmd* g_decodeCmds = 0;
+static unsigned g_decodeCmdsCapacity = 0;
+static short* g_decodePoints = 0;
+static unsigned g_decodePointsCapacity = 0;
+
+unsigned imguiCaptureFrameSize()
+{
+        const unsigned paddedText = ((unsigned)imguiGetTextPoolSize() + 3) & ~3u;
+        return FRAME_HEADER_SIZE + (unsigned)imguiGetRenderQueueSize()*RECORD_SIZE + paddedText +
+               (unsigned)imguiGetPointPoolSize()*POINT_SIZE;
+}
+
+void imguiCaptureEncodeFrame(unsigned char* dst, int width, int height)
+{
+        const imguiGfxCmd* q = imguiGetRenderQueue();
+        const unsigned nq = (unsigned)imguiGetRenderQueueSize();
+        const char* pool = imguiGetTextPool();
+        const unsigned textSize = (unsigned)imguiGetTextPoolSize();
+        const short* points = imguiGetPointPool();
+        const unsigned pointCount = (unsigned)imguiGetPointPoolSize();
+
+        unsigned char* p = dst;
+        memset(p, 0, imguiCaptureFrameSize());
+        put32(p, nq);
+        put32(p+4, textSize);
+        put16(p+8, (unsigned int)width);
+        put16(p+10, (unsigned int)height);
+        put32(p+12, pointCount);
+        p += FRAME_HEADER_SIZE;
+
+        for (unsigned i = 0; i < nq; ++i, p += RECORD_SIZE)
+        {
+                const imguiGfxCmd& cmd = q[i];
+                p[0] = (unsigned char)cmd.type;
+                p[1] = (unsigned char)cmd.flags;
+                put32(p+4, cmd.col);
+                if (cmd.type == IMGUI_GFXCMD_TEXT)
+                {
+                        put16(p+8, (unsigned short)cmd.text.x);
+                        put16(p+10, (unsigned short)cmd.text.y);
+                        put16(p+12, (unsigned short)cmd.text.align);
+                        put32(p+20, cmd.text.text ? (unsigned int)(cmd.text.text - pool) : NO_TEXT);
+                }
+                else if (cmd.type == IMGUI_GFXCMD_LINE)
+                {
+                        put16(p+8, (unsigned short)cmd.line.x0);
+                        put16(p+10, (unsigned short)cmd.line.y0);
+                        put16(p+12, (unsigned short)cmd.line.x1);
+                        put16(p+14, (unsigned short)cmd.line.y1);
+                        put16(p+16, (unsigned short)cmd.line.r);
+                }
+                else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+                {
+                        put16(p+8, cmd.poly.count);
+                        put16(p+10, (unsigned short)cmd.poly.r);
+                        put32(p+20, cmd.poly.points ? (unsigned int)(cmd.poly.points - points)/2 : NO_TEXT);
+                }
+                else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+                {
+                        put16(p+8, (unsigned short)cmd.image.x);
+                        put16(p+10, (unsigned short)cmd.image.y);
+                        put16(p+12, (unsigned short)cmd.image.w);
+                        put16(p+14, (unsigned short)cmd.image.h);
+                        put16(p+16, cmd.image.u0);
+                        put16(p+18, cmd.image.v0);
+                        put16(p+20, cmd.image.u1);
+                        put16(p+22, cmd.image.v1);
+                }
+                else
+                {
+                        put16(p+8, (unsigned short)cmd.rect.x);
+                        put16(p+10, (unsigned short)cmd.rect.y);
+                        put16(p+12, (unsigned short)cmd.rect.w);
+                        put16(p+14, (unsigned short)cmd.rect.h);
+                        put16(p+16, (unsigned short)cmd.rect.r);
+                }
+        }
+        memcpy(p, pool, textSize);
+        p += (textSize + 3) & ~3u;
+        for (unsigned i = 0; i < pointCount*2; ++i, p += 2)
+                put16(p, (unsigned short)points[i]);
+}
+
+bool imguiCaptureDecodeFrame(const unsigned char* src, unsigned size, int* width, int* height)
+{
+        if (size < FRAME_HEADER_SIZE)
+                return false;
+        const unsigned char* p = src;
+        const unsigned nq = get32(p);
+        const unsigned textSize = get32(p+4);
+        const unsigned pointCount = get32(p+12);
+        const unsigned long long paddedText = ((unsigned long long)textSize + 3) & ~3ull;
+        if ((unsigned long long)FRAME_HEADER_SIZE + (unsigned long long)nq*RECORD_SIZE + paddedText +
+            (unsigned long long)pointCount*POINT_SIZE > size)
+                return false;
+        // Strings are NUL terminated in the pool, so a pool that ends in one
+        // keeps every text offset below textSize inside it.
+        if (textSize && src[FRAME_HEADER_SIZE + nq*RECORD_SIZE + textSize - 1] != '\0')
+                return false;
+        if (!imguiReserve(g_decodeCmds, g_decodeCmdsCapacity, nq) ||
+            !imguiReserve(g_decodePoints, g_decodePointsCapacity, pointCount*2))
+                return false;
+        if (width) *width = (int)get16(p+8);
+        if (height) *height = (int)get16(p+10);
+        p += FRAME_HEADER_SIZE;
+
+        const char* text = (const char*)(p + nq*RECORD_SIZE);
+        const unsigned char* pointData = p + nq*RECORD_SIZE + paddedText;
+        for (unsigned i = 0; i < pointCount*2; ++i)
+                g_decodePoints[i] = (short)get16(pointData + i*2);
+        for (unsigned i = 0; i < nq; ++i, p += RECORD_SIZE)
+        {
+                imguiGfxCmd& cmd = g_decodeCmds[i];
+                memset(&cmd, 0, sizeof(cmd));
+                cmd.type = (char)p[0];
+                cmd.flags = (char)p[1];
+                cmd.col = get32(p+4);
+                if (cmd.type == IMGUI_GFXCMD_TEXT)
+                {
+                        const unsigned int textOffset = get32(p+20);
+                        cmd.text.x = (short)get16(p+8);
+                        cmd.text.y = (short)get16(p+10);
+                        cmd.text.align = (short)get16(p+12);
+                        cmd.text.text = textOffset < textSize ? text + textOffset : 0;
+                }
+                else if (cmd.type == IMGUI_GFXCMD_LINE)
+                {
+                        cmd.line.x0 = (short)get16(p+8);
+                        cmd.line.y0 = (short)get16(p+10);
+                        cmd.line.x1 = (short)get16(p+12);
+                        cmd.line.y1 = (short)get16(p+14);
+                        cmd.line.r = (short)get16(p+16);
+                }
+                else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+                {
+                        const unsigned int first = get32(p+20);
+                        cmd.poly.count = (unsigned short)get16(p+8);
+                        cmd.poly.r = (short)get16(p+10);
+                        if (first < pointCount && cmd.poly.count <= pointCount - first)
+                                cmd.poly.points = g_decodePoints + first*2;
+                        else
+                                cmd.poly.count = 0;
+                }
+                else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+                {
+                        cmd.image.x = (short)get16(p+8);
+                        cmd.image.y = (short)get16(p+10);
+                        cmd.image.w = (short)get16(p+12);
+                        cmd.image.h = (short)get16(p+14);
+                        cmd.image.u0 = (unsigned short)get16(p+16);
+                        cmd.image.v0 = (unsigned short)get16(p+18);
+                        cmd.image.u1 = (unsigned short)get16(p+20);
+                        cmd.image.v1 = (unsigned short)get16(p+22);
+                }
+                else
+                {
+                        cmd.rect.x = (short)get16(p+8);
+                        cmd.rect.y = (short)get16(p+10);
+                        cmd.rect.w = (short)get16(p+12);
+                        cmd.rect.h = (short)get16(p+14);
+                        cmd.rect.r = (short)get16(p+16);
+                }
+        }
+
+        imguiSetRenderQueue(g_decodeCmds, (int)nq, text, (int)textSize, g_decodePoints, (int)pointCount);
+        return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static FILE* g_captureFile = 0;
+static unsigned long long g_captureOffset = 0;
+static unsigned long long* g_frameOffsets = 0;
+static unsigned g_frameCount = 0;
+static unsigned g_frameOffsetsCapacity = 0;
+static unsigned char* g_encodeBuffer = 0;
+static unsigned g_encodeCapacity = 0;
+
+// A short write is rewound so the next frame overwrites it.
+static bool captureWrite(const void* data, unsigned size)
+{
+        if (fwrite(data, 1, size, g_captureFile) != size)
+        {
+                clearerr(g_captureFile);
+                fseek(g_captureFile, (long)g_captureOffset, SEEK_SET);
+                return false;
+        }
+        g_captureOffset += size;
+        return true;
+}
+
+bool imguiCaptureBegin(const char* path)
+{
+        if (g_captureFile)
+                imguiCaptureEnd();
+
+        g_captureFile = fopen(path, "wb");
+        if (!g_captureFile)
+                return false;
+        g_captureOffset = 0;
+        g_frameCount = 0;
+
+        unsigned char header[HEADER_SIZE];
+        memset(header, 0, sizeof(header));
+        memcpy(header, "IMGQ", 4);
+        put32(header+4, CAPTURE_VERSION);
+        return captureWrite(header, sizeof(header));
+}
+
+bool imguiCaptureFrame(int width, int height)
+{
+        if (!g_captureFile)
+                return false;
+
+        const unsigned size = imguiCaptureFrameSize();
+        if (!imguiReserve(g_encodeBuffer, g_encodeCapacity, size) ||
+            !imguiReserve(g_frameOffsets, g_frameOffsetsCapacity, g_frameCount+1))
+                return false;
+        imguiCaptureEncodeFrame(g_encodeBuffer, width, height);
+
+        const unsigned long long offset = g_captureOffset;
+        if (!captureWrite(g_encodeBuffer, size))
+                return false;
+        g_frameOffsets[g_frameCount++] = offset;
+        return true;
+}
+
+bool imguiCaptureEnd()
+{
+        if (!g_captureFile)
+                return false;
+
+        bool ok = true;
+        const unsigned long long indexOffset = g_captureOffset;
+        unsigned char buf[12];
+        put32(buf, g_frameCount);
+        ok = ok && captureWrite(buf, 4);
+        for (unsigned i = 0; i < g_frameCount && ok; ++i)
+        {
+                put64(buf, g_frameOffsets[i]);
+                ok = captureWrite(buf, 8);
+        }
+        put64(buf, indexOffset);
+        memcpy(buf+8, "IMGI", 4);
+        ok = ok && captureWrite(buf, FOOTER_SIZE);
+
+        ok = fclose(g_captureFile) == 0 && ok;
+        g_captureFile = 0;
+
+        imguiFree(g_frameOffsets);
+        g_frameOffsets = 0;
+        g_frameOffsetsCapacity = 0;
+        imguiFree(g_encodeBuffer);
+        g_encodeBuffer = 0;
+        g_encodeCapacity = 0;
+        return ok;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static const unsigned char* g_replayData = 0;
+static unsigned long long g_replaySize = 0;
+static const unsigned char* g_replayIndex = 0;
+static unsigned g_replayFrameCount = 0;
+
+static bool mapFile(const char* path)
+{
+#ifdef _WIN32
+        FILE* fp = fopen(path, "rb");
+        if (!fp)
+                return false;
+        fseek(fp, 0, SEEK_END);
+        const long size = ftell(fp);
+        fseek(fp, 0, SEEK_SET);
+        unsigned char* data = size > 0 ? (unsigned char*)imguiRealloc(0, size) : 0;
+        if (!data || fread(data, 1, size, fp) != (size_t)size)
+        {
+                imguiFree(data);
+                fclose(fp);
+                return false;
+        }
+        fclose(fp);
+        g_replayData = data;
+        g_replaySize = (unsigned long long)size;
+        return true;
+#else
+        const int fd = open(path, O_RDONLY);
+        if (fd < 0)
+                return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+                close(fd);
+                return false;
+        }
+        void* data = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED)
+                return false;
+        g_replayData = (const unsigned char*)data;
+        g_replaySize = (unsigned long long)st.st_size;
+        return true;
+#endif
+}
+
+static void unmapFile()
+{
+        if (!g_replayData)
+                return;
+#ifdef _WIN32
+        imguiFree((void*)g_replayData);
+#else
+        munmap((void*)g_replayData, (size_t)g_replaySize);
+#endif
+        g_replayData = 0;
+        g_replaySize = 0;
+}
+
+bool imguiReplayOpen(const char* path)
+{
+        imguiReplayClose();
+        if (!mapFile(path))
+                return false;
+
+        const unsigned char* d = g_replayData;
+        const unsigned long long size = g_replaySize;
+        if (size < HEADER_SIZE + FOOTER_SIZE + 4 || memcmp(d, "IMGQ", 4) != 0 || get32(d+4) == 0 || get32(d+4) > CAPTURE_VERSION ||
+            memcmp(d + size - 4, "IMGI", 4) != 0)
+        {
+                imguiReplayClose();
+                return false;
+        }
+
+        const unsigned long long indexOffset = get64(d + size - FOOTER_SIZE);
+        if (indexOffset + 4 > size - FOOTER_SIZE)
+        {
+                imguiReplayClose();
+                return false;
+        }
+        g_replayFrameCount = get32(d + indexOffset);
+        g_replayIndex = d + indexOffset + 4;
+        if (indexOffset + 4 + (unsigned long long)g_replayFrameCount*8 > size - FOOTER_SIZE)
+        {
+                imguiReplayClose();
+                return false;
+        }
+        return true;
+}
+
+void imguiReplayClose()
+{
+        unmapFile();
+        g_replayIndex = 0;
+        g_replayFrameCount = 0;
+        imguiFree(g_decodeCmds);
+        g_decodeCmds = 0;
+        g_decodeCmdsCapacity = 0;
+        imguiFree(g_decodePoints);
+        g_decodePoints = 0;
+        g_decodePointsCapacity = 0;
+}
+
+int imguiReplayFrameCount()
+{
+        return (int)g_replayFrameCount;
+}
+
+bool imguiReplayLoadFrame(int frame, int* width, int* height)
+{
+        if (frame < 0 || frame >= (int)g_replayFrameCount)
+                return false;
+
+        // Frames lie before the index, and none is larger than 4 GB.
+        const unsigned long long offset = get64(g_replayIndex + frame*8);
+        const unsigned long long end = (unsigned long long)(g_replayIndex - 4 - g_replayData);
+        if (offset >= end)
+                return false;
+        const unsigned long long size = end - offset;
+        return imguiCaptureDecodeFrame(g_replayData + offset, size < UINT_MAX ? (unsigned)size : UINT_MAX, width, height);
+}
@@ -0,0 +1,51 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_CAPTURE_H
+#define IMGUI_CAPTURE_H
+
+// Streams render queues to a binary file and loads them back into the
+// render queue, so captured frames can be fed to any renderer.
+//
+// File layout, little-endian:
+//   header   "IMGQ", version, 8 reserved bytes
+//   frames   command count, text size, width, height, point count,
+//            24-byte command records, text pool padded to 4 bytes,
+//            16-bit x,y polyline points (version 2)
+//   index    frame count, 64-bit file offset of each frame
+//   footer   64-bit offset of the index, "IMGI"
+
+bool imguiCaptureBegin(const char* path);
+bool imguiCaptureFrame(int width, int height);
+bool imguiCaptureEnd();
+
+// Encodes the current render queue as one frame record, as stored in the
+// file. Used to stream frames elsewhere.
+unsigned imguiCaptureFrameSize();
+void imguiCaptureEncodeFrame(unsigned char* dst, int width, int height);
+bool imguiCaptureDecodeFrame(const unsigned char* src, unsigned size, int* width, int* height);
+
+bool imguiReplayOpen(const char* path);
+void imguiReplayClose();
+int imguiReplayFrameCount();
+// Loads a captured frame into the render queue.
+bool imguiReplayLoadFrame(int frame, int* width, int* height);
+
+#endif // IMGUI_CAPTURE_H
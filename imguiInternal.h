@@ -0,0 +1,175 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_INTERNAL_H
+#define IMGUI_INTERNAL_H
+
+#include <math.h>
+
+#include "imgui.h"
+
+// Helpers shared by the core and the renderers. Not part of the API.
+
+static const float IMGUI_TAB_STOPS[4] = {150, 210, 270, 330};
+
+// Pen position after a tab at x, relative to the start of the text.
+inline float imguiNextTabStop(float x)
+{
+        for (int i = 0; i < 4; ++i)
+        {
+                if (x < IMGUI_TAB_STOPS[i])
+                        return IMGUI_TAB_STOPS[i];
+        }
+        return x;
+}
+
+// Width of a line of text as the renderers lay it out, tabs included.
+// glyphs.place(c, x, right) returns the advance of character c at pen
+// position x and, when c is drawn, sets 'right' to its right edge.
+template<typename Glyphs>
+float imguiTextWidth(const char* text, const Glyphs& glyphs)
+{
+        float x = 0;
+        float width = 0;
+        for (; *text; ++text)
+        {
+                const unsigned char c = (unsigned char)*text;
+                if (c == '\t')
+                        x = imguiNextTabStop(x);
+                else
+                        x += glyphs.place(c, x, width);
+        }
+        return width;
+}
+
+// Glyphs of a font baked with stbtt_BakeFontBitmap(), characters 32 to 127.
+template<typename BakedChar>
+struct imguiBakedGlyphs
+{
+        const BakedChar* chardata;
+
+        float place(unsigned char c, float x, float& right) const
+        {
+                if (c < 32 || c >= 128)
+                        return 0;
+                const BakedChar* b = chardata + c-32;
+                const int round_x = (int)floor((x + b->xoff) + 0.5);
+                right = round_x + b->x1 - b->x0 + 0.5f;
+                return b->xadvance;
+        }
+};
+
+// Polyline strokes, shared by the GL tessellation and the software renderer
+// so both draw the same joins. Corners are mitered up to IMGUI_MITER_LIMIT
+// half widths and beveled past it.
+static const float IMGUI_MITER_LIMIT = 4.0f;
+
+// Cross-section of a stroke: vertices at p + a*w on the plus side and at
+// p - b*w on the minus side, where a and b are scaled normals.
+struct imguiStrokeSection
+{
+        float ax, ay, bx, by;
+};
+
+// Direction (seg[0], seg[1]) and length in pixels (seg[2]) of the segment
+// from point a to point b, the points being in the queue's 1/8 pixel units.
+inline void imguiPolylineSegment(const short* pts, unsigned a, unsigned b, float* seg)
+{
+        float dx = (float)(pts[b*2] - pts[a*2]);
+        float dy = (float)(pts[b*2+1] - pts[a*2+1]);
+        float d = sqrtf(dx*dx+dy*dy);
+        if (d > 0)
+        {
+                const float id = 1.0f/d;
+                dx *= id;
+                dy *= id;
+        }
+        seg[0] = dx;
+        seg[1] = dy;
+        seg[2] = d*(1.0f/8.0f);
+}
+
+// Sections at a corner from segment 0 into segment 1, returns 1 for a miter
+// and 2 for a bevel. A bevel's outer side follows each segment's normal;
+// the inner side meets at the inner miter point when both segments are
+// longer than it reaches, 'reach' being the stroke's outer half width.
+inline int imguiJoinSections(const float* s0, const float* s1, float reach, bool bevel, imguiStrokeSection* out)
+{
+        const float nx = (s0[1] + s1[1]) * 0.5f;
+        const float ny = -(s0[0] + s1[0]) * 0.5f;
+        const float dmr2 = nx*nx + ny*ny;
+        const float cross = s0[0]*s1[1] - s0[1]*s1[0];
+        if (dmr2*IMGUI_MITER_LIMIT*IMGUI_MITER_LIMIT >= 1.0f && !(bevel && fabsf(cross) > 0.001f))
+        {
+                const float scale = 1.0f / dmr2;
+                out[0].ax = out[0].bx = nx*scale;
+                out[0].ay = out[0].by = ny*scale;
+                return 1;
+        }
+
+        const float len = s0[2] < s1[2] ? s0[2] : s1[2];
+        const bool innerMiter = dmr2 > 0.000001f && reach*reach <= dmr2*len*len;
+        for (int i = 0; i < 2; ++i)
+        {
+                const float* d = i == 0 ? s0 : s1;
+                float ix = d[1], iy = -d[0];
+                if (innerMiter)
+                {
+                        ix = nx / dmr2;
+                        iy = ny / dmr2;
+                }
+                // Turning towards the minus side puts the plus side outside.
+                if (cross > 0)
+                {
+                        out[i].ax = d[1];
+                        out[i].ay = -d[0];
+                        out[i].bx = ix;
+                        out[i].by = iy;
+                }
+                else
+                {
+                        out[i].ax = ix;
+                        out[i].ay = iy;
+                        out[i].bx = d[1];
+                        out[i].by = -d[0];
+                }
+        }
+        return 2;
+}
+
+// Grows a buffer from the imgui allocator to hold 'count' elements,
+// doubling from 'minCapacity'. On failure the buffer is left as it was.
+template<typename T>
+bool imguiReserve(T*& ptr, unsigned& capacity, unsigned count, unsigned minCapacity = 256)
+{
+        if (count <= capacity)
+                return true;
+        unsigned n = capacity ? capacity : minCapacity;
+        while (n < count)
+                n *= 2;
+        T* p = (T*)imguiRealloc(ptr, n*sizeof(T));
+        if (!p)
+                return false;
+        ptr = p;
+        capacity = n;
+        return true;
+}
+
+#endif // IMGUI_INTERNAL_H
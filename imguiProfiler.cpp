@@ -0,0 +1,183 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#include "imguiProfiler.h"
+
+#ifdef IMGUI_ENABLE_PROFILER
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <new>
+
+#include "imgui.h"
+
+// Each thread owns a ring of completed zones. Only the owning thread
+// writes 'head', publishing with a release store that the exporter reads
+// with acquire. Zone fields are relaxed atomics behind a release fence,
+// so the exporter can read a slot the owner is overwriting and detect it
+// by reading 'head' again, as with a seqlock. Reset moves 'base' up to
+// the head instead of clearing it, so it never races the owner. Buffers
+// are linked into a global list on first use with a CAS and live until
+// the process exits, so zones from finished threads can still be written
+// out. They come from the imgui allocator hooks.
+
+static const unsigned PROFILE_RING_SIZE = 1 << 16;
+static const unsigned PROFILE_MAX_DEPTH = 32;
+
+struct ProfileZone
+{
+        std::atomic<const char*> name;
+        std::atomic<unsigned long long> start;
+        std::atomic<unsigned long long> duration;
+};
+
+struct ProfileThread
+{
+        ProfileZone zones[PROFILE_RING_SIZE];
+        std::atomic<unsigned> head;
+        std::atomic<unsigned> base;
+        unsigned id;
+        ProfileThread* next;
+
+        const char* stackName[PROFILE_MAX_DEPTH];
+        unsigned long long stackStart[PROFILE_MAX_DEPTH];
+        unsigned depth;
+};
+
+static std::atomic<ProfileThread*> g_threads(0);
+static std::atomic<unsigned> g_threadCount(0);
+static thread_local ProfileThread* t_thread = 0;
+static const std::chrono::steady_clock::time_point g_epoch = std::chrono::steady_clock::now();
+
+static unsigned long long nowNanoseconds()
+{
+        return (unsigned long long)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_epoch).count();
+}
+
+static ProfileThread* getThread()
+{
+        if (t_thread)
+                return t_thread;
+        void* mem = imguiRealloc(0, sizeof(ProfileThread));
+        if (!mem)
+                return 0;
+        ProfileThread* t = new (mem) ProfileThread;
+        t->head.store(0);
+        t->base.store(0);
+        t->id = ++g_threadCount;
+        t->depth = 0;
+        t->next = g_threads.load();
+        while (!g_threads.compare_exchange_weak(t->next, t))
+                ;
+        t_thread = t;
+        return t;
+}
+
+void imguiProfileBegin(const char* name)
+{
+        ProfileThread* t = getThread();
+        if (!t)
+                return;
+        if (t->depth < PROFILE_MAX_DEPTH)
+        {
+                t->stackName[t->depth] = name;
+                t->stackStart[t->depth] = nowNanoseconds();
+        }
+        t->depth++;
+}
+
+void imguiProfileEnd()
+{
+        ProfileThread* t = getThread();
+        if (!t || t->depth == 0)
+                return;
+        t->depth--;
+        if (t->depth >= PROFILE_MAX_DEPTH)
+                return;
+
+        const unsigned head = t->head.load(std::memory_order_relaxed);
+        const unsigned long long start = t->stackStart[t->depth];
+        const unsigned long long duration = nowNanoseconds() - start;
+        ProfileZone& z = t->zones[head % PROFILE_RING_SIZE];
+        // An exporter that sees any of these stores also sees 'head' at
+        // least at this slot's index, and so knows the slot was reused.
+        std::atomic_thread_fence(std::memory_order_release);
+        z.name.store(t->stackName[t->depth], std::memory_order_relaxed);
+        z.start.store(start, std::memory_order_relaxed);
+        z.duration.store(duration, std::memory_order_relaxed);
+        t->head.store(head+1, std::memory_order_release);
+}
+
+void imguiProfileReset()
+{
+        for (ProfileThread* t = g_threads.load(); t; t = t->next)
+                t->base.store(t->head.load(std::memory_order_acquire), std::memory_order_release);
+}
+
+static void writeName(FILE* fp, const char* name)
+{
+        fputc('"', fp);
+        for (const char* c = name ? name : "?"; *c; ++c)
+        {
+                if (*c == '"' || *c == '\\')
+                        fputc('\\', fp);
+                if ((unsigned char)*c >= 0x20)
+                        fputc(*c, fp);
+        }
+        fputc('"', fp);
+}
+
+bool imguiProfileWriteTrace(const char* path)
+{
+        FILE* fp = fopen(path, "w");
+        if (!fp)
+                return false;
+
+        fprintf(fp, "{\"traceEvents\":[\n");
+        bool first = true;
+        for (ProfileThread* t = g_threads.load(); t; t = t->next)
+        {
+                const unsigned head = t->head.load(std::memory_order_acquire);
+                const unsigned recorded = head - t->base.load(std::memory_order_acquire);
+                const unsigned count = recorded < PROFILE_RING_SIZE ? recorded : PROFILE_RING_SIZE;
+                for (unsigned i = head - count; i != head; ++i)
+                {
+                        const ProfileZone& z = t->zones[i % PROFILE_RING_SIZE];
+                        const char* name = z.name.load(std::memory_order_relaxed);
+                        const unsigned long long start = z.start.load(std::memory_order_relaxed);
+                        const unsigned long long duration = z.duration.load(std::memory_order_relaxed);
+                        // The owner may have wrapped around while we copied;
+                        // skip slots it has started to overwrite since.
+                        std::atomic_thread_fence(std::memory_order_acquire);
+                        if (t->head.load(std::memory_order_relaxed) - i >= PROFILE_RING_SIZE)
+                                continue;
+                        fprintf(fp, "%s{\"name\":", first ? "" : ",\n");
+                        writeName(fp, name);
+                        fprintf(fp, ",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                                t->id, (double)start / 1000.0, (double)duration / 1000.0);
+                        first = false;
+                }
+        }
+        fprintf(fp, "\n],\"displayTimeUnit\":\"ns\"}\n");
+        return fclose(fp) == 0;
+}
+
+#endif // IMGUI_ENABLE_PROFILER
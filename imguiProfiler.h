@@ -0,0 +1,58 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_PROFILER_H
+#define IMGUI_PROFILER_H
+
+// Scoped CPU timing zones, recorded per thread into a ring buffer and
+// written out as Chrome trace events (chrome://tracing, Perfetto).
+// Define IMGUI_ENABLE_PROFILER to build it in; otherwise the macros expand
+// to nothing. Zone names must outlive the trace, e.g. string literals.
+
+#ifdef IMGUI_ENABLE_PROFILER
+
+void imguiProfileBegin(const char* name);
+void imguiProfileEnd();
+// Drops all recorded zones. May be called while other threads record.
+void imguiProfileReset();
+// Zones overwritten by their thread while the file is written are left out.
+bool imguiProfileWriteTrace(const char* path);
+
+struct imguiProfileScope
+{
+        imguiProfileScope(const char* name) { imguiProfileBegin(name); }
+        ~imguiProfileScope() { imguiProfileEnd(); }
+};
+
+#define IMGUI_PROFILE_CONCAT2(a, b) a##b
+#define IMGUI_PROFILE_CONCAT(a, b) IMGUI_PROFILE_CONCAT2(a, b)
+#define IMGUI_PROFILE_BEGIN(name) imguiProfileBegin(name)
+#define IMGUI_PROFILE_END() imguiProfileEnd()
+#define IMGUI_PROFILE_SCOPE(name) imguiProfileScope IMGUI_PROFILE_CONCAT(imguiProfileScope_, __LINE__)(name)
+
+#else
+
+#define IMGUI_PROFILE_BEGIN(name)
+#define IMGUI_PROFILE_END()
+#define IMGUI_PROFILE_SCOPE(name)
+
+#endif // IMGUI_ENABLE_PROFILER
+
+#endif // IMGUI_PROFILER_H
@@ -0,0 +1,560 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef _WIN32
+#       include <errno.h>
+#       include <netdb.h>
+#       include <poll.h>
+#       include <time.h>
+#       include <unistd.h>
+#       include <netinet/in.h>
+#       include <netinet/tcp.h>
+#       include <sys/socket.h>
+#endif
+
+#include "imguiRemote.h"
+#include "imguiCapture.h"
+#include "imgui.h"
+#include "imguiInternal.h"
+
+// Messages are an 8 byte header (type, payload size) and a payload.
+//   input  mx, my, scroll, buttons, width, height, 64-bit client time in us
+//   frame  encoded size, 64-bit echoed client time, compressed delta
+//
+// Delta compression, one control byte c per run:
+//   c < 0x80            c+1 literal bytes follow
+//   0x80 <= c < 0xff    c-0x7f zero bytes
+//   c == 0xff           32-bit count of zero bytes follows
+
+enum RemoteMessage
+{
+        MSG_INPUT = 1,
+        MSG_FRAME = 2,
+};
+
+static const unsigned MSG_HEADER_SIZE = 8;
+static const unsigned INPUT_SIZE = 32;
+static const unsigned FRAME_INFO_SIZE = 12;
+static const unsigned MAX_MESSAGE_SIZE = 16*1024*1024;
+
+inline void put32(unsigned char* p, unsigned int v)
+{
+        p[0] = (unsigned char)(v & 0xff);
+        p[1] = (unsigned char)((v >> 8) & 0xff);
+        p[2] = (unsigned char)((v >> 16) & 0xff);
+        p[3] = (unsigned char)((v >> 24) & 0xff);
+}
+
+inline void put64(unsigned char* p, unsigned long long v)
+{
+        put32(p, (unsigned int)(v & 0xffffffff));
+        put32(p+4, (unsigned int)(v >> 32));
+}
+
+inline unsigned int get32(const unsigned char* p)
+{
+        return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned int)p[3] << 24);
+}
+
+inline unsigned long long get64(const unsigned char* p)
+{
+        return get32(p) | ((unsigned long long)get32(p+4) << 32);
+}
+
+struct RemoteConnection
+{
+        int readFd, writeFd;
+        bool open;
+
+        // Received bytes not consumed yet.
+        unsigned char* recv;
+        unsigned recvSize, recvCapacity;
+        // Last frame encoding, the delta reference on both ends.
+        unsigned char* frame;
+        unsigned frameSize, frameCapacity;
+        // Scratch for encoding and outgoing messages.
+        unsigned char* scratch;
+        unsigned scratchCapacity;
+        unsigned char* send;
+        unsigned sendCapacity;
+
+        imguiRemoteStats stats;
+};
+
+static RemoteConnection g_server;
+static RemoteConnection g_client;
+
+// Server input state.
+static int g_inputX = -1, g_inputY = -1;
+static unsigned char g_inputButtons = 0;
+static int g_inputWidth = 0, g_inputHeight = 0;
+static unsigned long long g_inputTime = 0;
+
+#ifndef _WIN32
+
+static unsigned long long nowMicroseconds()
+{
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec*1000000ull + ts.tv_nsec/1000;
+}
+
+static void initConnection(RemoteConnection& c, int readFd, int writeFd)
+{
+        memset(&c, 0, sizeof(c));
+        c.readFd = readFd;
+        c.writeFd = writeFd;
+        c.open = true;
+}
+
+static void freeConnection(RemoteConnection& c)
+{
+        imguiFree(c.recv);
+        imguiFree(c.frame);
+        imguiFree(c.scratch);
+        imguiFree(c.send);
+        memset(&c, 0, sizeof(c));
+}
+
+static bool writeAll(RemoteConnection& c, const unsigned char* data, unsigned size)
+{
+        while (size > 0)
+        {
+                const ssize_t n = write(c.writeFd, data, size);
+                if (n < 0 && errno == EINTR)
+                        continue;
+                if (n <= 0)
+                {
+                        c.open = false;
+                        return false;
+                }
+                data += n;
+                size -= (unsigned)n;
+                c.stats.sentBytes += (unsigned long long)n;
+        }
+        return true;
+}
+
+// Reads whatever is available within timeoutMs. Returns false when the
+// connection is closed.
+static bool readAvailable(RemoteConnection& c, int timeoutMs)
+{
+        struct pollfd pfd;
+        pfd.fd = c.readFd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        const int res = poll(&pfd, 1, timeoutMs);
+        if (res < 0)
+                return errno == EINTR;
+        if (res == 0)
+                return true;
+
+        static const unsigned CHUNK = 64*1024;
+        if (!imguiReserve(c.recv, c.recvCapacity, c.recvSize + CHUNK, 4096))
+                return false;
+        ssize_t n;
+        do
+                n = read(c.readFd, c.recv + c.recvSize, CHUNK);
+        while (n < 0 && errno == EINTR);
+        if (n <= 0)
+        {
+                c.open = false;
+                return false;
+        }
+        c.recvSize += (unsigned)n;
+        c.stats.receivedBytes += (unsigned long long)n;
+        return true;
+}
+
+// Returns the payload of the first complete message in the receive buffer.
+static const unsigned char* peekMessage(RemoteConnection& c, unsigned* type, unsigned* size)
+{
+        if (c.recvSize < MSG_HEADER_SIZE)
+                return 0;
+        *type = get32(c.recv);
+        *size = get32(c.recv+4);
+        if (*size > MAX_MESSAGE_SIZE)
+        {
+                c.open = false;
+                return 0;
+        }
+        if (c.recvSize < MSG_HEADER_SIZE + *size)
+                return 0;
+        return c.recv + MSG_HEADER_SIZE;
+}
+
+static void consumeMessage(RemoteConnection& c)
+{
+        const unsigned size = MSG_HEADER_SIZE + get32(c.recv+4);
+        memmove(c.recv, c.recv + size, c.recvSize - size);
+        c.recvSize -= size;
+}
+
+static unsigned emitLiterals(unsigned char* dst, const unsigned char* cur, const unsigned char* prev, unsigned prevSize, unsigned start, unsigned end)
+{
+        unsigned char* p = dst;
+        while (start < end)
+        {
+                const unsigned n = end - start < 128 ? end - start : 128;
+                *p++ = (unsigned char)(n-1);
+                for (unsigned i = start; i < start+n; ++i)
+                        *p++ = cur[i] ^ (i < prevSize ? prev[i] : 0);
+                start += n;
+        }
+        return (unsigned)(p - dst);
+}
+
+// Compresses cur XOR prev into dst, which must hold size + size/128 + 16 bytes.
+static unsigned compressDelta(unsigned char* dst, const unsigned char* cur, unsigned size, const unsigned char* prev, unsigned prevSize)
+{
+        unsigned char* p = dst;
+        unsigned literal = 0;
+        unsigned i = 0;
+        while (i < size)
+        {
+                unsigned zeros = 0;
+                while (i+zeros < size && cur[i+zeros] == (i+zeros < prevSize ? prev[i+zeros] : 0))
+                        zeros++;
+                if (zeros < 3 && i+zeros < size)
+                {
+                        i += zeros ? zeros : 1;
+                        continue;
+                }
+                p += emitLiterals(p, cur, prev, prevSize, literal, i);
+                if (zeros < 128)
+                {
+                        *p++ = (unsigned char)(0x7f + zeros);
+                }
+                else
+                {
+                        *p++ = 0xff;
+                        put32(p, zeros);
+                        p += 4;
+                }
+                i += zeros;
+                literal = i;
+        }
+        p += emitLiterals(p, cur, prev, prevSize, literal, size);
+        return (unsigned)(p - dst);
+}
+
+// XORs the delta into frame, which already holds the previous frame.
+static bool decompressDelta(unsigned char* frame, unsigned size, const unsigned char* src, unsigned srcSize)
+{
+        const unsigned char* end = src + srcSize;
+        unsigned i = 0;
+        while (src < end)
+        {
+                const unsigned c = *src++;
+                if (c < 0x80)
+                {
+                        const unsigned n = c+1;
+                        if (i+n > size || src+n > end)
+                                return false;
+                        for (unsigned j = 0; j < n; ++j)
+                                frame[i++] ^= *src++;
+                }
+                else if (c < 0xff)
+                {
+                        i += c - 0x7f;
+                }
+                else
+                {
+                        if (src+4 > end)
+                                return false;
+                        i += get32(src);
+                        src += 4;
+                }
+        }
+        return i == size;
+}
+
+int imguiRemoteListen(const char* host, int port)
+{
+        struct addrinfo hints, *res = 0;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags = AI_PASSIVE;
+        char service[16];
+        snprintf(service, sizeof(service), "%d", port);
+        if (getaddrinfo(host, service, &hints, &res) != 0)
+                return -1;
+
+        int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+        if (fd >= 0)
+        {
+                const int one = 1;
+                setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+                if (bind(fd, res->ai_addr, res->ai_addrlen) != 0 || listen(fd, 1) != 0)
+                {
+                        close(fd);
+                        fd = -1;
+                }
+        }
+        freeaddrinfo(res);
+        if (fd < 0)
+                return -1;
+
+        const int conn = accept(fd, 0, 0);
+        close(fd);
+        if (conn >= 0)
+        {
+                const int one = 1;
+                setsockopt(conn, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return conn;
+}
+
+int imguiRemoteConnect(const char* host, int port)
+{
+        struct addrinfo hints, *res = 0;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        char service[16];
+        snprintf(service, sizeof(service), "%d", port);
+        if (getaddrinfo(host, service, &hints, &res) != 0)
+                return -1;
+
+        int fd = -1;
+        for (struct addrinfo* ai = res; ai && fd < 0; ai = ai->ai_next)
+        {
+                fd = socket(ai->ai_family, ai->ai_socktype, ai->ai_protocol);
+                if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) != 0)
+                {
+                        close(fd);
+                        fd = -1;
+                }
+        }
+        freeaddrinfo(res);
+        if (fd >= 0)
+        {
+                const int one = 1;
+                setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        return fd;
+}
+
+bool imguiRemoteServerInit(int readFd, int writeFd)
+{
+        imguiRemoteServerShutdown();
+        initConnection(g_server, readFd, writeFd);
+        g_inputX = g_inputY = -1;
+        g_inputButtons = 0;
+        g_inputWidth = g_inputHeight = 0;
+        g_inputTime = 0;
+        return readFd >= 0 && writeFd >= 0;
+}
+
+void imguiRemoteServerShutdown()
+{
+        if (g_server.open || g_server.recv || g_server.frame)
+                freeConnection(g_server);
+}
+
+bool imguiRemoteServerPollInput(int* mx, int* my, unsigned char* mbut, int* scroll, int* width, int* height)
+{
+        RemoteConnection& c = g_server;
+        if (c.open)
+                readAvailable(c, 0);
+
+        // Scroll accumulates, but stop at a button change so that clicks
+        // shorter than a frame still reach the UI.
+        int accumScroll = 0;
+        unsigned consumed = 0;
+        unsigned type, size;
+        while (const unsigned char* msg = peekMessage(c, &type, &size))
+        {
+                if (type == MSG_INPUT && size >= INPUT_SIZE)
+                {
+                        const unsigned char buttons = (unsigned char)get32(msg+12);
+                        if (consumed > 0 && buttons != g_inputButtons)
+                                break;
+                        g_inputX = (int)get32(msg);
+                        g_inputY = (int)get32(msg+4);
+                        accumScroll += (int)get32(msg+8);
+                        g_inputButtons = buttons;
+                        g_inputWidth = (int)get32(msg+16);
+                        g_inputHeight = (int)get32(msg+20);
+                        g_inputTime = get64(msg+24);
+                        consumed++;
+                }
+                consumeMessage(c);
+        }
+
+        if (mx) *mx = g_inputX;
+        if (my) *my = g_inputY;
+        if (mbut) *mbut = g_inputButtons;
+        if (scroll) *scroll = accumScroll;
+        if (width) *width = g_inputWidth;
+        if (height) *height = g_inputHeight;
+        return c.open || c.recvSize >= MSG_HEADER_SIZE;
+}
+
+bool imguiRemoteServerSendFrame()
+{
+        RemoteConnection& c = g_server;
+        if (!c.open)
+                return false;
+
+        const unsigned size = imguiCaptureFrameSize();
+        const unsigned maxPacked = MSG_HEADER_SIZE + FRAME_INFO_SIZE + size + size/128 + 16;
+        if (!imguiReserve(c.scratch, c.scratchCapacity, size, 4096) || !imguiReserve(c.send, c.sendCapacity, maxPacked, 4096))
+                return false;
+        imguiCaptureEncodeFrame(c.scratch, g_inputWidth, g_inputHeight);
+
+        unsigned char* msg = c.send;
+        const unsigned packed = compressDelta(msg + MSG_HEADER_SIZE + FRAME_INFO_SIZE, c.scratch, size, c.frame, c.frameSize);
+        put32(msg, MSG_FRAME);
+        put32(msg+4, FRAME_INFO_SIZE + packed);
+        put32(msg+8, size);
+        put64(msg+12, g_inputTime);
+
+        // The encoded frame becomes the reference for the next delta.
+        unsigned char* tmp = c.frame;
+        const unsigned tmpCapacity = c.frameCapacity;
+        c.frame = c.scratch;
+        c.frameCapacity = c.scratchCapacity;
+        c.frameSize = size;
+        c.scratch = tmp;
+        c.scratchCapacity = tmpCapacity;
+
+        c.stats.frames++;
+        c.stats.rawBytes += size;
+        return writeAll(c, msg, MSG_HEADER_SIZE + FRAME_INFO_SIZE + packed);
+}
+
+const imguiRemoteStats* imguiRemoteServerStats()
+{
+        return &g_server.stats;
+}
+
+bool imguiRemoteClientInit(int readFd, int writeFd)
+{
+        imguiRemoteClientShutdown();
+        initConnection(g_client, readFd, writeFd);
+        return readFd >= 0 && writeFd >= 0;
+}
+
+void imguiRemoteClientShutdown()
+{
+        if (g_client.open || g_client.recv || g_client.frame)
+                freeConnection(g_client);
+}
+
+bool imguiRemoteClientSendInput(int mx, int my, unsigned char mbut, int scroll, int width, int height)
+{
+        RemoteConnection& c = g_client;
+        if (!c.open)
+                return false;
+        unsigned char msg[MSG_HEADER_SIZE + INPUT_SIZE];
+        put32(msg, MSG_INPUT);
+        put32(msg+4, INPUT_SIZE);
+        unsigned char* p = msg + MSG_HEADER_SIZE;
+        put32(p, (unsigned int)mx);
+        put32(p+4, (unsigned int)my);
+        put32(p+8, (unsigned int)scroll);
+        put32(p+12, mbut);
+        put32(p+16, (unsigned int)width);
+        put32(p+20, (unsigned int)height);
+        put64(p+24, nowMicroseconds());
+        return writeAll(c, msg, sizeof(msg));
+}
+
+int imguiRemoteClientReceiveFrame(int timeoutMs)
+{
+        RemoteConnection& c = g_client;
+        const unsigned long long deadline = nowMicroseconds() + (unsigned long long)(timeoutMs > 0 ? timeoutMs : 0)*1000;
+        bool received = false;
+        unsigned long long echo = 0;
+
+        for (;;)
+        {
+                unsigned type, size;
+                while (const unsigned char* msg = peekMessage(c, &type, &size))
+                {
+                        if (type == MSG_FRAME && size >= FRAME_INFO_SIZE)
+                        {
+                                const unsigned frameSize = get32(msg);
+                                if (!imguiReserve(c.frame, c.frameCapacity, frameSize, 4096))
+                                        return -1;
+                                if (frameSize > c.frameSize)
+                                        memset(c.frame + c.frameSize, 0, frameSize - c.frameSize);
+                                c.frameSize = frameSize;
+                                if (!decompressDelta(c.frame, frameSize, msg + FRAME_INFO_SIZE, size - FRAME_INFO_SIZE))
+                                        return -1;
+                                echo = get64(msg+4);
+                                c.stats.frames++;
+                                c.stats.rawBytes += frameSize;
+                                received = true;
+                        }
+                        consumeMessage(c);
+                }
+                if (!c.open)
+                        break;
+
+                // Drain whatever else has arrived, but only wait when no
+                // frame has been received yet.
+                const unsigned long long now = nowMicroseconds();
+                const int wait = received || now >= deadline ? 0 : (int)((deadline - now + 999) / 1000);
+                const unsigned before = c.recvSize;
+                if (!readAvailable(c, wait))
+                        break;
+                if (c.recvSize == before && (received || wait == 0))
+                        break;
+        }
+
+        if (!received)
+                return c.open ? 0 : -1;
+
+        if (echo)
+        {
+                c.stats.roundTripMs = (float)(nowMicroseconds() - echo) / 1000.0f;
+                c.stats.avgRoundTripMs += (c.stats.roundTripMs - c.stats.avgRoundTripMs) / (float)c.stats.frames;
+        }
+        return imguiCaptureDecodeFrame(c.frame, c.frameSize, 0, 0) ? 1 : -1;
+}
+
+const imguiRemoteStats* imguiRemoteClientStats()
+{
+        return &g_client.stats;
+}
+
+#else
+
+int imguiRemoteListen(const char*, int) { return -1; }
+int imguiRemoteConnect(const char*, int) { return -1; }
+bool imguiRemoteServerInit(int, int) { return false; }
+void imguiRemoteServerShutdown() {}
+bool imguiRemoteServerPollInput(int*, int*, unsigned char*, int*, int*, int*) { return false; }
+bool imguiRemoteServerSendFrame() { return false; }
+const imguiRemoteStats* imguiRemoteServerStats() { return &g_server.stats; }
+bool imguiRemoteClientInit(int, int) { return false; }
+void imguiRemoteClientShutdown() {}
+bool imguiRemoteClientSendInput(int, int, unsigned char, int, int, int) { return false; }
+int imguiRemoteClientReceiveFrame(int) { return -1; }
+const imguiRemoteStats* imguiRemoteClientStats() { return &g_client.stats; }
+
+#endif
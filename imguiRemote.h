@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_REMOTE_H
+#define IMGUI_REMOTE_H
+
+// Streams render queues from a process without a display to a client that
+// draws them, and sends the client's input back. Each frame is encoded like
+// a capture frame (imguiCapture.h), XORed against the previous one and sent
+// with runs of zero bytes compressed. Works over any pair of POSIX file
+// descriptors: a socket, or two pipes. The descriptors stay owned by the
+// caller.
+
+struct imguiRemoteStats
+{
+        unsigned int frames;
+        unsigned long long rawBytes;            // Encoded frame size before delta compression.
+        unsigned long long sentBytes;
+        unsigned long long receivedBytes;
+        float roundTripMs;                      // Client only, input sent to frame received.
+        float avgRoundTripMs;
+};
+
+// TCP helpers, return a connected socket or -1.
+int imguiRemoteListen(const char* host, int port);
+int imguiRemoteConnect(const char* host, int port);
+
+bool imguiRemoteServerInit(int readFd, int writeFd);
+void imguiRemoteServerShutdown();
+// Applies input received since the last call, keeps the previous values
+// otherwise. Returns false once the client is gone.
+bool imguiRemoteServerPollInput(int* mx, int* my, unsigned char* mbut, int* scroll, int* width, int* height);
+// Sends the current render queue, call after the last draw call of the frame.
+bool imguiRemoteServerSendFrame();
+const imguiRemoteStats* imguiRemoteServerStats();
+
+bool imguiRemoteClientInit(int readFd, int writeFd);
+void imguiRemoteClientShutdown();
+bool imguiRemoteClientSendInput(int mx, int my, unsigned char mbut, int scroll, int width, int height);
+// Waits up to timeoutMs for frames and loads the newest one into the render
+// queue. Returns 1 when a frame was loaded, 0 on timeout, -1 on error.
+int imguiRemoteClientReceiveFrame(int timeoutMs);
+const imguiRemoteStats* imguiRemoteClientStats();
+
+#endif // IMGUI_REMOTE_H
@@ -21,316 +21,306 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include <iostream>
+#include <chrono>
 
 #include "imguiRenderGL3.h"
 #include <yip-imports/gl.h>
 
 #include "imgui.h"
+#include "imguiInternal.h"
 
-// Some math headers don't have PI defined.
-static const float PI = 3.14159265f;
+#include "imguiTessellate.h"
+#include "imguiProfiler.h"
 
-#include <yip-imports/stb_truetype.h>
-
-static const unsigned TEMP_COORD_COUNT = 100;
-static float g_tempCoords[TEMP_COORD_COUNT*2];
-static float g_tempNormals[TEMP_COORD_COUNT*2];
-static float g_tempVertices[TEMP_COORD_COUNT * 12 + (TEMP_COORD_COUNT - 2) * 6];
-static float g_tempTextureCoords[TEMP_COORD_COUNT * 12 + (TEMP_COORD_COUNT - 2) * 6];
-static float g_tempColors[TEMP_COORD_COUNT * 24 + (TEMP_COORD_COUNT - 2) * 12];
-
-static const int CIRCLE_VERTS = 8*4;
-static float g_circleVerts[CIRCLE_VERTS*2];
-
-static stbtt_bakedchar g_cdata[96]; // ASCII 32..126 is 95 glyphs
 static GL::UInt g_ftex = 0;
 static GL::UInt g_whitetex = 0;
 static GL::UInt g_program = 0;
 static GL::UInt g_programViewportLocation = 0;
 static GL::UInt g_programTextureLocation = 0;
+static GL::UInt g_programImageLocation = 0;
+
+static imguiDrawList g_drawList;
 
-inline unsigned int RGBA(unsigned char r, unsigned char g, unsigned char b, unsigned char a)
+static void printInfoLog(GL::UInt object, bool program, const char* what)
 {
-        return (r) | (g << 8) | (b << 16) | (a << 24);
+        GL::Int logLength = 0;
+        if (program)
+                GL::getProgramiv(object, GL::INFO_LOG_LENGTH, &logLength);
+        else
+                GL::getShaderiv(object, GL::INFO_LOG_LENGTH, &logLength);
+        if (logLength <= 0)
+                return;
+        char* log = (char*)imguiRealloc(0, (size_t)logLength + 1);
+        if (!log)
+                return;
+        log[0] = '\0';
+        if (program)
+                GL::getProgramInfoLog(object, logLength, nullptr, log);
+        else
+                GL::getShaderInfoLog(object, logLength, nullptr, log);
+        log[logLength] = '\0';
+        std::clog << what << log << std::endl;
+        imguiFree(log);
 }
 
-static void drawPolygon(const float* coords, unsigned numCoords, float r, unsigned int col)
+static float g_gpuTime = -1.0f;
+
+// Timer queries and multi-draw indirect need desktop GL entry points that
+// the GLES2 import lacks. They are built only with IMGUI_GL_DESKTOP, and
+// without them frames go untimed and draw a range at a time.
+#ifdef IMGUI_GL_DESKTOP
+
+// GL_TIME_ELAPSED queries around the UI draw, read back a few frames later.
+// A frame goes untimed rather than waiting when every query is in flight.
+static const int GPU_QUERY_COUNT = 4;
+static GL::UInt g_gpuQueries[GPU_QUERY_COUNT];
+static bool g_gpuQueryPending[GPU_QUERY_COUNT];
+static int g_gpuQueryNext = 0;
+static bool g_gpuTimerSupported = false;
+
+// Desktop GL version of the current context, false on GL ES.
+static bool getGLVersion(int& major, int& minor)
 {
-        if (numCoords > TEMP_COORD_COUNT) numCoords = TEMP_COORD_COUNT;
-        
-        for (unsigned i = 0, j = numCoords-1; i < numCoords; j=i++)
-        {
-                const float* v0 = &coords[j*2];
-                const float* v1 = &coords[i*2];
-                float dx = v1[0] - v0[0];
-                float dy = v1[1] - v0[1];
-                float d = sqrtf(dx*dx+dy*dy);
-                if (d > 0)
-                {
-                        d = 1.0f/d;
-                        dx *= d;
-                        dy *= d;
-                }
-                g_tempNormals[j*2+0] = dy;
-                g_tempNormals[j*2+1] = -dx;
-        }
-        
-        float colf[4] = { (float) (col&0xff) / 255.f, (float) ((col>>8)&0xff) / 255.f, (float) ((col>>16)&0xff) / 255.f, (float) ((col>>24)&0xff) / 255.f};
-        float colTransf[4] = { (float) (col&0xff) / 255.f, (float) ((col>>8)&0xff) / 255.f, (float) ((col>>16)&0xff) / 255.f, 0};
+        const char* version = (const char*)GL::getString(GL::VERSION);
+        if (!version || strncmp(version, "OpenGL ES", 9) == 0)
+                return false;
+        return sscanf(version, "%d.%d", &major, &minor) == 2;
+}
 
-        for (unsigned i = 0, j = numCoords-1; i < numCoords; j=i++)
-        {
-                float dlx0 = g_tempNormals[j*2+0];
-                float dly0 = g_tempNormals[j*2+1];
-                float dlx1 = g_tempNormals[i*2+0];
-                float dly1 = g_tempNormals[i*2+1];
-                float dmx = (dlx0 + dlx1) * 0.5f;
-                float dmy = (dly0 + dly1) * 0.5f;
-                float   dmr2 = dmx*dmx + dmy*dmy;
-                if (dmr2 > 0.000001f)
-                {
-                        float   scale = 1.0f / dmr2;
-                        if (scale > 10.0f) scale = 10.0f;
-                        dmx *= scale;
-                        dmy *= scale;
-                }
-                g_tempCoords[i*2+0] = coords[i*2+0]+dmx*r;
-                g_tempCoords[i*2+1] = coords[i*2+1]+dmy*r;
-        }
-        
-        int vSize = numCoords * 12 + (numCoords - 2) * 6;
-        int uvSize = numCoords * 2 * 6 + (numCoords - 2) * 2 * 3;
-        int cSize = numCoords * 4 * 6 + (numCoords - 2) * 4 * 3;
-        float * v = g_tempVertices;
-        float * uv = g_tempTextureCoords;
-        memset(uv, 0, uvSize * sizeof(float));
-        float * c = g_tempColors;
-        memset(c, 1, cSize * sizeof(float));
-
-        float * ptrV = v;
-        float * ptrC = c;
-        for (unsigned i = 0, j = numCoords-1; i < numCoords; j=i++)
+static bool hasExtension(const char* name)
+{
+        GL::Int count = 0;
+        GL::getIntegerv(GL::NUM_EXTENSIONS, &count);
+        for (GL::Int i = 0; i < count; ++i)
         {
-            *ptrV = coords[i*2];
-            *(ptrV+1) = coords[i*2 + 1];
-            ptrV += 2;
-            *ptrV = coords[j*2];
-            *(ptrV+1) = coords[j*2 + 1];
-            ptrV += 2;          
-            *ptrV = g_tempCoords[j*2];
-            *(ptrV+1) = g_tempCoords[j*2 + 1];
-            ptrV += 2;                     
-            *ptrV = g_tempCoords[j*2];
-            *(ptrV+1) = g_tempCoords[j*2 + 1];
-            ptrV += 2;                     
-            *ptrV = g_tempCoords[i*2];
-            *(ptrV+1) = g_tempCoords[i*2 + 1];
-            ptrV += 2;                     
-            *ptrV = coords[i*2];
-            *(ptrV+1) = coords[i*2 + 1];            
-            ptrV += 2;
-
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;
-            *ptrC = colTransf[0];
-            *(ptrC+1) = colTransf[1];
-            *(ptrC+2) = colTransf[2];
-            *(ptrC+3) = colTransf[3];
-            ptrC += 4;
-            *ptrC = colTransf[0];
-            *(ptrC+1) = colTransf[1];
-            *(ptrC+2) = colTransf[2];
-            *(ptrC+3) = colTransf[3];
-            ptrC += 4;
-            *ptrC = colTransf[0];
-            *(ptrC+1) = colTransf[1];
-            *(ptrC+2) = colTransf[2];
-            *(ptrC+3) = colTransf[3];
-            ptrC += 4;
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;
+                const char* ext = (const char*)GL::getStringi(GL::EXTENSIONS, i);
+                if (ext && strcmp(ext, name) == 0)
+                        return true;
         }
-        
-        for (unsigned i = 2; i < numCoords; ++i)
-        {
-            *ptrV = coords[0];
-            *(ptrV+1) = coords[1];
-            ptrV += 2;
-            *ptrV = coords[(i-1)*2];
-            *(ptrV+1) = coords[(i-1)*2+1];
-            ptrV += 2;  
-            *ptrV = coords[i*2];
-            *(ptrV+1) = coords[i*2 + 1];            
-            ptrV += 2;            
-
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;
-            *ptrC = colf[0];
-            *(ptrC+1) = colf[1];
-            *(ptrC+2) = colf[2];
-            *(ptrC+3) = colf[3];
-            ptrC += 4;          
-        }        
-        GL::bindTexture(GL::TEXTURE_2D, g_whitetex);
-        
-        GL::enableVertexAttribArray(0);
-        GL::enableVertexAttribArray(1);
-        GL::enableVertexAttribArray(2);
-        GL::vertexAttribPointer(0, 2, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*2, v);
-        GL::vertexAttribPointer(1, 2, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*2, uv);
-        GL::vertexAttribPointer(2, 4, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*4, c);
-        GL::drawArrays(GL::TRIANGLES, 0, (numCoords * 2 + numCoords - 2)*3);
-        GL::disableVertexAttribArray(0);
-        GL::disableVertexAttribArray(1);
-        GL::disableVertexAttribArray(2);
- 
+        return false;
 }
 
-static void drawRect(float x, float y, float w, float h, float fth, unsigned int col)
+static bool hasTimerQuery()
 {
-        float verts[4*2] =
-        {
-                x+0.5f, y+0.5f,
-                x+w-0.5f, y+0.5f,
-                x+w-0.5f, y+h-0.5f,
-                x+0.5f, y+h-0.5f,
-        };
-        drawPolygon(verts, 4, fth, col);
+        int major = 0, minor = 0;
+        if (!getGLVersion(major, minor))
+                return false;
+        if (major > 3 || (major == 3 && minor >= 3))
+                return true;
+        return major == 3 && hasExtension("GL_ARB_timer_query");
 }
 
-/*
-static void drawEllipse(float x, float y, float w, float h, float fth, unsigned int col)
+static void readGpuQueries()
 {
-        float verts[CIRCLE_VERTS*2];
-        const float* cverts = g_circleVerts;
-        float* v = verts;
-        
-        for (int i = 0; i < CIRCLE_VERTS; ++i)
+        // Oldest first, so g_gpuTime ends up with the newest result.
+        for (int i = 0; i < GPU_QUERY_COUNT; ++i)
         {
-                *v++ = x + cverts[i*2]*w;
-                *v++ = y + cverts[i*2+1]*h;
+                const int q = (g_gpuQueryNext + i) % GPU_QUERY_COUNT;
+                if (!g_gpuQueryPending[q])
+                        continue;
+                GL::UInt available = 0;
+                GL::getQueryObjectuiv(g_gpuQueries[q], GL::QUERY_RESULT_AVAILABLE, &available);
+                if (!available)
+                        break;
+                GL::UInt64 ns = 0;
+                GL::getQueryObjectui64v(g_gpuQueries[q], GL::QUERY_RESULT, &ns);
+                g_gpuTime = (float)((double)ns / 1.0e6);
+                g_gpuQueryPending[q] = false;
         }
-        
-        drawPolygon(verts, CIRCLE_VERTS, fth, col);
 }
-*/
 
-static void drawRoundedRect(float x, float y, float w, float h, float r, float fth, unsigned int col)
+// Multi-draw indirect, GL 4.3 or ARB_multi_draw_indirect with
+// ARB_base_instance on GL 3.3. Each range of the draw list becomes an
+// indirect command and one call submits every range until the texture
+// changes between the font and an image. The clip rect and texture mode of
+// each range sit in a per-draw buffer of instanced attributes, which the
+// range indexes with its base instance.
+struct IndirectCommand
 {
-        const unsigned n = CIRCLE_VERTS/4;
-        float verts[(n+1)*4*2];
-        const float* cverts = g_circleVerts;
-        float* v = verts;
-        
-        for (unsigned i = 0; i <= n; ++i)
-        {
-                *v++ = x+w-r + cverts[i*2]*r;
-                *v++ = y+h-r + cverts[i*2+1]*r;
-        }
-        
-        for (unsigned i = n; i <= n*2; ++i)
-        {
-                *v++ = x+r + cverts[i*2]*r;
-                *v++ = y+h-r + cverts[i*2+1]*r;
-        }
-        
-        for (unsigned i = n*2; i <= n*3; ++i)
-        {
-                *v++ = x+r + cverts[i*2]*r;
-                *v++ = y+r + cverts[i*2+1]*r;
-        }
-        
-        for (unsigned i = n*3; i < n*4; ++i)
-        {
-                *v++ = x+w-r + cverts[i*2]*r;
-                *v++ = y+r + cverts[i*2+1]*r;
-        }
-        *v++ = x+w-r + cverts[0]*r;
-        *v++ = y+r + cverts[1]*r;
-        
-        drawPolygon(verts, (n+1)*4, fth, col);
-}
+        GL::UInt count;
+        GL::UInt instanceCount;
+        GL::UInt firstIndex;
+        GL::Int baseVertex;
+        GL::UInt baseInstance;
+};
+
+enum IndirectMode
+{
+        INDIRECT_WHITE = 0,
+        INDIRECT_FONT = 1,
+        INDIRECT_IMAGE = 2,
+};
 
+struct IndirectDrawState
+{
+        float clip[4];
+        GL::UInt mode;
+};
 
-static void drawLine(float x0, float y0, float x1, float y1, float r, float fth, unsigned int col)
+enum IndirectBuffer
+{
+        INDIRECT_VERTICES,
+        INDIRECT_INDICES,
+        INDIRECT_COMMANDS,
+        INDIRECT_STATES,
+        INDIRECT_BUFFER_COUNT,
+};
+
+static bool g_multiDrawSupported = false;
+static bool g_multiDraw = false;
+static GL::UInt g_mdiProgram = 0;
+static GL::UInt g_mdiViewportLocation = 0;
+static GL::UInt g_mdiTextureLocation = 0;
+static GL::UInt g_mdiVao = 0;
+static GL::UInt g_mdiBuffers[INDIRECT_BUFFER_COUNT];
+static IndirectCommand* g_mdiCommands = 0;
+static unsigned g_mdiCommandCapacity = 0;
+static IndirectDrawState* g_mdiStates = 0;
+static unsigned g_mdiStateCapacity = 0;
+
+static bool hasMultiDraw()
 {
-        float dx = x1-x0;
-        float dy = y1-y0;
-        float d = sqrtf(dx*dx+dy*dy);
-        if (d > 0.0001f)
+        int major = 0, minor = 0;
+        if (!getGLVersion(major, minor))
+                return false;
+        if (major > 4 || (major == 4 && minor >= 3))
+                return true;
+        return (major > 3 || (major == 3 && minor >= 3)) &&
+                hasExtension("GL_ARB_multi_draw_indirect") && hasExtension("GL_ARB_base_instance");
+}
+
+static bool initMultiDraw()
+{
+        if (!hasMultiDraw())
+                return false;
+
+        const char* vs =
+        "#version 330 core\n"
+        "uniform vec2 Viewport;\n"
+        "layout(location = 0) in vec2 VertexPosition;\n"
+        "layout(location = 1) in vec2 VertexTexCoord;\n"
+        "layout(location = 2) in vec4 VertexColor;\n"
+        "layout(location = 3) in vec4 DrawClip;\n"
+        "layout(location = 4) in uint DrawMode;\n"
+        "out vec2 texCoord;\n"
+        "out vec4 vertexColor;\n"
+        "flat out vec4 clip;\n"
+        "flat out uint mode;\n"
+        "void main(void)\n"
+        "{\n"
+        "    vertexColor = VertexColor;\n"
+        "    texCoord = VertexTexCoord;\n"
+        "    clip = DrawClip;\n"
+        "    mode = DrawMode;\n"
+        "    gl_Position = vec4(VertexPosition * 2.0 / Viewport - 1.0, 0.0, 1.0);\n"
+        "}\n";
+        const char* fs =
+        "#version 330 core\n"
+        "uniform sampler2D Texture;\n"
+        "in vec2 texCoord;\n"
+        "in vec4 vertexColor;\n"
+        "flat in vec4 clip;\n"
+        "flat in uint mode;\n"
+        "out vec4 fragColor;\n"
+        "void main(void)\n"
+        "{\n"
+        "    if (any(lessThan(gl_FragCoord.xy, clip.xy)) || any(greaterThanEqual(gl_FragCoord.xy, clip.zw)))\n"
+        "        discard;\n"
+        "    vec4 texel = texture(Texture, texCoord);\n"
+        "    if (mode == 0u)\n"
+        "        texel = vec4(1.0);\n"
+        "    fragColor = mode == 2u ? vertexColor * texel : vec4(vertexColor.rgb, vertexColor.a * texel.r);\n"
+        "}\n";
+
+        GL::UInt vso = GL::createShader(GL::VERTEX_SHADER);
+        GL::shaderSource(vso, 1, &vs, NULL);
+        GL::compileShader(vso);
+        printInfoLog(vso, false, "Compiling imgui multi-draw vertex shader: ");
+        GL::UInt fso = GL::createShader(GL::FRAGMENT_SHADER);
+        GL::shaderSource(fso, 1, &fs, NULL);
+        GL::compileShader(fso);
+        printInfoLog(fso, false, "Compiling imgui multi-draw fragment shader: ");
+
+        g_mdiProgram = GL::createProgram();
+        GL::attachShader(g_mdiProgram, vso);
+        GL::attachShader(g_mdiProgram, fso);
+        GL::linkProgram(g_mdiProgram);
+        GL::deleteShader(vso);
+        GL::deleteShader(fso);
+        GL::Int linked = 0;
+        GL::getProgramiv(g_mdiProgram, GL::LINK_STATUS, &linked);
+        if (!linked)
         {
-                d = 1.0f/d;
-                dx *= d;
-                dy *= d;
+                printInfoLog(g_mdiProgram, true, "Linking imgui multi-draw program:\n");
+                GL::deleteProgram(g_mdiProgram);
+                g_mdiProgram = 0;
+                return false;
         }
-        float nx = dy;
-        float ny = -dx;
-        float verts[4*2];
-        r -= fth;
-        r *= 0.5f;
-        if (r < 0.01f) r = 0.01f;
-        dx *= r;
-        dy *= r;
-        nx *= r;
-        ny *= r;
-        
-        verts[0] = x0-dx-nx;
-        verts[1] = y0-dy-ny;
-        
-        verts[2] = x0-dx+nx;
-        verts[3] = y0-dy+ny;
-        
-        verts[4] = x1+dx+nx;
-        verts[5] = y1+dy+ny;
-        
-        verts[6] = x1+dx-nx;
-        verts[7] = y1+dy-ny;
-        
-        drawPolygon(verts, 4, fth, col);
+        g_mdiViewportLocation = GL::getUniformLocation(g_mdiProgram, "Viewport");
+        g_mdiTextureLocation = GL::getUniformLocation(g_mdiProgram, "Texture");
+
+        GL::genBuffers(INDIRECT_BUFFER_COUNT, g_mdiBuffers);
+        GL::genVertexArrays(1, &g_mdiVao);
+        GL::bindVertexArray(g_mdiVao);
+        GL::bindBuffer(GL::ARRAY_BUFFER, g_mdiBuffers[INDIRECT_VERTICES]);
+        GL::vertexAttribPointer(0, 2, GL::FLOAT, GL::FALSE, sizeof(imguiVertex), (const void*)offsetof(imguiVertex, x));
+        GL::vertexAttribPointer(1, 2, GL::FLOAT, GL::FALSE, sizeof(imguiVertex), (const void*)offsetof(imguiVertex, u));
+        GL::vertexAttribPointer(2, 4, GL::UNSIGNED_BYTE, GL::TRUE, sizeof(imguiVertex), (const void*)offsetof(imguiVertex, col));
+        GL::bindBuffer(GL::ARRAY_BUFFER, g_mdiBuffers[INDIRECT_STATES]);
+        GL::vertexAttribPointer(3, 4, GL::FLOAT, GL::FALSE, sizeof(IndirectDrawState), (const void*)offsetof(IndirectDrawState, clip));
+        GL::vertexAttribIPointer(4, 1, GL::UNSIGNED_INT, sizeof(IndirectDrawState), (const void*)offsetof(IndirectDrawState, mode));
+        GL::vertexAttribDivisor(3, 1);
+        GL::vertexAttribDivisor(4, 1);
+        for (GL::UInt i = 0; i < 5; ++i)
+                GL::enableVertexAttribArray(i);
+        GL::bindBuffer(GL::ELEMENT_ARRAY_BUFFER, g_mdiBuffers[INDIRECT_INDICES]);
+        GL::bindVertexArray(0);
+        GL::bindBuffer(GL::ARRAY_BUFFER, 0);
+        return true;
 }
 
-
-bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
+static void destroyMultiDraw()
 {
-        for (int i = 0; i < CIRCLE_VERTS; ++i)
+        if (g_mdiProgram)
         {
-                float a = (float)i/(float)CIRCLE_VERTS * PI*2;
-                g_circleVerts[i*2+0] = cosf(a);
-                g_circleVerts[i*2+1] = sinf(a);
+                GL::deleteProgram(g_mdiProgram);
+                GL::deleteVertexArrays(1, &g_mdiVao);
+                GL::deleteBuffers(INDIRECT_BUFFER_COUNT, g_mdiBuffers);
+                g_mdiProgram = 0;
+                g_mdiVao = 0;
         }
+        imguiFree(g_mdiCommands);
+        g_mdiCommands = 0;
+        g_mdiCommandCapacity = 0;
+        imguiFree(g_mdiStates);
+        g_mdiStates = 0;
+        g_mdiStateCapacity = 0;
+        g_multiDrawSupported = false;
+        g_multiDraw = false;
+}
+#endif // IMGUI_GL_DESKTOP
 
+bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
+{
         // Load font.
         std::string ttfBuffer = loader.loadResource(fontpath);
         
-        unsigned char* bmap = (unsigned char*)malloc(512*512);
+        unsigned char* bmap = (unsigned char*)imguiRealloc(0, 512*512);
         if (!bmap)
         {
                 return false;
         }
         
-        stbtt_BakeFontBitmap((const unsigned char *)ttfBuffer.data(),0, 15.0f, bmap,512,512, 32,96, g_cdata);
+        if (!imguiTessInit((const unsigned char *)ttfBuffer.data(), bmap, 512, 512))
+        {
+                imguiFree(bmap);
+                return false;
+        }
         
         // can free ttf_buffer at this point
         GL::genTextures(1, &g_ftex);
@@ -348,7 +338,6 @@ bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
         GL::texParameteri(GL::TEXTURE_2D, GL::TEXTURE_MAG_FILTER, GL::LINEAR);
 
         g_program = GL::createProgram();
-        GL::Int logLength;
     
         const char * vs =
 //        "#version 150\n"
@@ -368,14 +357,7 @@ bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
         GL::shaderSource(vso, 1, (const char **)  &vs, NULL);
 
         GL::compileShader(vso);
-        logLength = 0;
-        GL::getShaderiv(vso, GL::INFO_LOG_LENGTH, &logLength);
-        if (logLength > 0)
-        {
-            std::vector<char> log(static_cast<size_t>(logLength + 1), 0);
-            GL::getShaderInfoLog(vso, logLength, nullptr, log.data());
-            std::clog << "Compiling imgui vertex shader: " << log.data() << std::endl;
-        }
+        printInfoLog(vso, false, "Compiling imgui vertex shader: ");
 
         GL::attachShader(g_program, vso);
 
@@ -387,25 +369,18 @@ bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
         "varying vec2 texCoord;\n"
         "varying vec4 vertexColor;\n"
         "uniform sampler2D Texture;\n"
+        "uniform float Image;\n"
         "void main(void)\n"
         "{\n"
-        "    float alpha = texture2D(Texture, texCoord).r;\n"
-        "    gl_FragColor = vec4(vertexColor.rgb, vertexColor.a * alpha);\n"
+        "    vec4 texel = texture2D(Texture, texCoord);\n"
+        "    gl_FragColor = mix(vec4(vertexColor.rgb, vertexColor.a * texel.r), vertexColor * texel, Image);\n"
         "}\n";
         GL::UInt fso = GL::createShader(GL::FRAGMENT_SHADER);
 
         GL::shaderSource(fso, 1, (const char **) &fs, NULL);
         GL::compileShader(fso);
 
-        GL::compileShader(fso);
-        logLength = 0;
-        GL::getShaderiv(vso, GL::INFO_LOG_LENGTH, &logLength);
-        if (logLength > 0)
-        {
-            std::vector<char> log(static_cast<size_t>(logLength + 1), 0);
-            GL::getShaderInfoLog(fso, logLength, nullptr, log.data());
-            std::clog << "Compiling imgui fragment shader: " << log.data() << std::endl;
-        }
+        printInfoLog(fso, false, "Compiling imgui fragment shader: ");
 
         GL::attachShader(g_program, fso);
 
@@ -414,14 +389,7 @@ bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
         GL::bindAttribLocation(g_program,  2,  "VertexColor");
 
         GL::linkProgram(g_program);
-        logLength = 0;
-        GL::getProgramiv(g_program, GL::INFO_LOG_LENGTH, &logLength);
-        if (logLength > 0)
-        {
-            std::vector<char> log(static_cast<size_t>(logLength + 1), 0);
-            GL::getProgramInfoLog(g_program, logLength, nullptr, log.data());
-            std::clog << "Linking imgui program:\n" << log.data() << std::endl;
-        }
+        printInfoLog(g_program, true, "Linking imgui program:\n");
 
         GL::deleteShader(vso);
         GL::deleteShader(fso);
@@ -429,11 +397,24 @@ bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath)
         GL::useProgram(g_program);
         g_programViewportLocation = GL::getUniformLocation(g_program, "Viewport");
         g_programTextureLocation = GL::getUniformLocation(g_program, "Texture");
+        g_programImageLocation = GL::getUniformLocation(g_program, "Image");
 
         GL::useProgram(0);
 
+#ifdef IMGUI_GL_DESKTOP
+        g_multiDrawSupported = initMultiDraw();
+        g_multiDraw = false;
 
-        free(bmap);
+        g_gpuTimerSupported = hasTimerQuery();
+        if (g_gpuTimerSupported)
+                GL::genQueries(GPU_QUERY_COUNT, g_gpuQueries);
+        for (int i = 0; i < GPU_QUERY_COUNT; ++i)
+                g_gpuQueryPending[i] = false;
+        g_gpuQueryNext = 0;
+#endif
+        g_gpuTime = -1.0f;
+
+        imguiFree(bmap);
 
         return true;
 }
@@ -452,222 +433,250 @@ void imguiRenderGLDestroy()
             g_program = 0;
         }
 
-}
+#ifdef IMGUI_GL_DESKTOP
+        if (g_gpuTimerSupported)
+        {
+                GL::deleteQueries(GPU_QUERY_COUNT, g_gpuQueries);
+                g_gpuTimerSupported = false;
+        }
+#endif
 
-static void getBakedQuad(stbtt_bakedchar *chardata, int pw, int ph, int char_index,
-                                                 float *xpos, float *ypos, stbtt_aligned_quad *q)
-{
-        stbtt_bakedchar *b = chardata + char_index;
-        int round_x = (int)floor(*xpos + b->xoff);
-        int round_y = (int)floor(*ypos - b->yoff);
-        
-        q->x0 = (float)round_x;
-        q->y0 = (float)round_y;
-        q->x1 = (float)round_x + b->x1 - b->x0;
-        q->y1 = (float)round_y - b->y1 + b->y0;
-        
-        q->s0 = b->x0 / (float)pw;
-        q->t0 = b->y0 / (float)pw;
-        q->s1 = b->x1 / (float)ph;
-        q->t1 = b->y1 / (float)ph;
-        
-        *xpos += b->xadvance;
-}
+#ifdef IMGUI_GL_DESKTOP
+        destroyMultiDraw();
+#endif
 
-static const float g_tabStops[4] = {150, 210, 270, 330};
+        imguiTessFreeDrawList(&g_drawList);
 
-static float getTextLength(stbtt_bakedchar *chardata, const char* text)
-{
-        float xpos = 0;
-        float len = 0;
-        while (*text)
-        {
-                int c = (unsigned char)*text;
-                if (c == '\t')
-                {
-                        for (int i = 0; i < 4; ++i)
-                        {
-                                if (xpos < g_tabStops[i])
-                                {
-                                        xpos = g_tabStops[i];
-                                        break;
-                                }
-                        }
-                }
-                else if (c >= 32 && c < 128)
-                {
-                        stbtt_bakedchar *b = chardata + c-32;
-                        int round_x = (int)floor((xpos + b->xoff) + 0.5);
-                        len = round_x + b->x1 - b->x0 + 0.5f;
-                        xpos += b->xadvance;
-                }
-                ++text;
-        }
-        return len;
 }
 
-static void drawText(float x, float y, const char *text, int align, unsigned int col)
+static void drawDirect(int width, int height, imguiFrameStats* stats)
 {
-        if (!g_ftex) return;
-        if (!text) return;
-        
-        if (align == IMGUI_ALIGN_CENTER)
-                x -= getTextLength(g_cdata, text)/2;
-        else if (align == IMGUI_ALIGN_RIGHT)
-                x -= getTextLength(g_cdata, text);
-        
-        float r = (float) (col&0xff) / 255.f;
-        float g = (float) ((col>>8)&0xff) / 255.f;
-        float b = (float) ((col>>16)&0xff) / 255.f;
-        float a = (float) ((col>>24)&0xff) / 255.f;
+        GL::useProgram(g_program);
+        GL::uniform2f(g_programViewportLocation, (float) width, (float) height);
+        GL::uniform1i(g_programTextureLocation, 0);
+        GL::uniform1f(g_programImageLocation, 0.0f);
 
-        // assume orthographic projection with units = screen pixels, origin at top left
         GL::enableVertexAttribArray(0);
         GL::enableVertexAttribArray(1);
         GL::enableVertexAttribArray(2);
-        GL::bindTexture(GL::TEXTURE_2D, g_ftex);
-        
-        const float ox = x;
-        
-        while (*text)
+
+        // Font and white textures hold coverage in the red channel, images
+        // are sampled as RGBA.
+        bool image = false;
+        const imguiDrawCmd* prev = 0;
+        for (unsigned i = 0; i < g_drawList.cmdCount; ++i)
         {
-                int c = (unsigned char)*text;
-                if (c == '\t')
+                const imguiDrawCmd& cmd = g_drawList.cmds[i];
+                if (cmd.clip)
                 {
-                        for (int i = 0; i < 4; ++i)
+                        if (!prev || !prev->clip)
+                                GL::enable(GL::SCISSOR_TEST);
+                        if (!prev || !prev->clip || prev->clipX != cmd.clipX || prev->clipY != cmd.clipY ||
+                            prev->clipW != cmd.clipW || prev->clipH != cmd.clipH)
                         {
-                                if (x < g_tabStops[i]+ox)
-                                {
-                                        x = g_tabStops[i]+ox;
-                                        break;
-                                }
+                                GL::scissor(cmd.clipX, cmd.clipY, cmd.clipW, cmd.clipH);
+                                stats->scissorChanges++;
                         }
                 }
-                else if (c >= 32 && c < 128)
-                {                       
-                        stbtt_aligned_quad q;
-                        getBakedQuad(g_cdata, 512,512, c-32, &x,&y,&q);
-
-                        float v[12] = {
-                                        q.x0, q.y0, 
-                                        q.x1, q.y1,
-                                        q.x1, q.y0, 
-                                        q.x0, q.y0,
-                                        q.x0, q.y1, 
-                                        q.x1, q.y1, 
-                                      };
-                        float uv[12] = {
-                                        q.s0, q.t0,
-                                        q.s1, q.t1,
-                                        q.s1, q.t0,
-                                        q.s0, q.t0, 
-                                        q.s0, q.t1, 
-                                        q.s1, q.t1, 
-                                      };
-                        float c[24] = {
-                                        r, g, b, a,
-                                        r, g, b, a,
-                                        r, g, b, a,
-                                        r, g, b, a,
-                                        r, g, b, a,
-                                        r, g, b, a,
-                                      };
-                        GL::vertexAttribPointer(0, 2, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*2, v);
-                        GL::vertexAttribPointer(1, 2, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*2, uv);
-                        GL::vertexAttribPointer(2, 4, GL::FLOAT, GL::FALSE, sizeof(GL::FLOAT)*4, c);
-                        GL::drawArrays(GL::TRIANGLES, 0, 6);
+                else if (prev && prev->clip)
+                {
+                        GL::disable(GL::SCISSOR_TEST);
+                        stats->scissorChanges++;
+                }
 
+                if (!prev || prev->texture != cmd.texture)
+                {
+                        const bool builtin = cmd.texture == IMGUI_TEXTURE_FONT || cmd.texture == IMGUI_TEXTURE_WHITE;
+                        if (cmd.texture == IMGUI_TEXTURE_FONT)
+                                GL::bindTexture(GL::TEXTURE_2D, g_ftex);
+                        else if (cmd.texture == IMGUI_TEXTURE_WHITE)
+                                GL::bindTexture(GL::TEXTURE_2D, g_whitetex);
+                        else
+                                GL::bindTexture(GL::TEXTURE_2D, cmd.texture);
+                        if (image == builtin)
+                        {
+                                image = !builtin;
+                                GL::uniform1f(g_programImageLocation, image ? 1.0f : 0.0f);
+                        }
+                        stats->textureBinds++;
                 }
-                ++text;
+                prev = &cmd;
+
+                const imguiVertex* v = g_drawList.vertices + cmd.vertexOffset;
+                GL::vertexAttribPointer(0, 2, GL::FLOAT, GL::FALSE, sizeof(imguiVertex), &v->x);
+                GL::vertexAttribPointer(1, 2, GL::FLOAT, GL::FALSE, sizeof(imguiVertex), &v->u);
+                GL::vertexAttribPointer(2, 4, GL::UNSIGNED_BYTE, GL::TRUE, sizeof(imguiVertex), &v->col);
+                GL::drawElements(GL::TRIANGLES, cmd.indexCount, GL::UNSIGNED_SHORT, g_drawList.indices + cmd.indexOffset);
+                stats->drawCalls++;
         }
-        
-        //glEnd();        
-        //glDisable(GL::TEXTURE_2D);
+
         GL::disableVertexAttribArray(0);
         GL::disableVertexAttribArray(1);
         GL::disableVertexAttribArray(2);
-}
+        GL::disable(GL::SCISSOR_TEST);
 
+        // Client arrays, which the driver copies draw by draw.
+        stats->uploadBytes += (int)(g_drawList.vertexCount*sizeof(imguiVertex) + g_drawList.indexCount*sizeof(unsigned short));
+}
 
-void imguiRenderGLDraw(int width, int height)
+#ifdef IMGUI_GL_DESKTOP
+// Returns false, drawing nothing, when out of memory.
+static bool drawIndirect(int width, int height, imguiFrameStats* stats)
 {
-        const imguiGfxCmd* q = imguiGetRenderQueue();
-        int nq = imguiGetRenderQueueSize();
-
-        const float s = 1.0f/8.0f;
-
-        GL::viewport(0, 0, width, height);
-        GL::useProgram(g_program);
-	GL::activeTexture(GL::TEXTURE0);
-        GL::uniform2f(g_programViewportLocation, (float) width, (float) height);
-        GL::uniform1i(g_programTextureLocation, 0);
-
-        GL::enable(GL::BLEND);
-        GL::blendFunc(GL::SRC_ALPHA, GL::ONE_MINUS_SRC_ALPHA);
-        GL::disable(GL::DEPTH_TEST);
+        const unsigned n = g_drawList.cmdCount;
+        if (!n)
+                return true;
+        if (!imguiReserve(g_mdiCommands, g_mdiCommandCapacity, n) || !imguiReserve(g_mdiStates, g_mdiStateCapacity, n))
+                return false;
 
-        GL::disable(GL::SCISSOR_TEST);
-        for (int i = 0; i < nq; ++i)
+        for (unsigned i = 0; i < n; ++i)
         {
-                const imguiGfxCmd& cmd = q[i];
-                if (cmd.type == IMGUI_GFXCMD_RECT)
+                const imguiDrawCmd& cmd = g_drawList.cmds[i];
+                IndirectCommand& ic = g_mdiCommands[i];
+                ic.count = cmd.indexCount;
+                ic.instanceCount = 1;
+                ic.firstIndex = cmd.indexOffset;
+                ic.baseVertex = (GL::Int)cmd.vertexOffset;
+                ic.baseInstance = i;
+
+                IndirectDrawState& state = g_mdiStates[i];
+                if (cmd.clip)
                 {
-                        if (cmd.rect.r == 0)
-                        {
-                                drawRect((float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
-                                                 (float)cmd.rect.w*s-1, (float)cmd.rect.h*s-1,
-                                                 1.0f, cmd.col);
-                        }
-                        else
-                        {
-                                drawRoundedRect((float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
-                                                                (float)cmd.rect.w*s-1, (float)cmd.rect.h*s-1,
-                                                                (float)cmd.rect.r*s, 1.0f, cmd.col);
-                        }
+                        state.clip[0] = cmd.clipX;
+                        state.clip[1] = cmd.clipY;
+                        state.clip[2] = (float)(cmd.clipX + cmd.clipW);
+                        state.clip[3] = (float)(cmd.clipY + cmd.clipH);
                 }
-                else if (cmd.type == IMGUI_GFXCMD_LINE)
+                else
                 {
-                        drawLine(cmd.line.x0*s, cmd.line.y0*s, cmd.line.x1*s, cmd.line.y1*s, cmd.line.r*s, 1.0f, cmd.col);
+                        state.clip[0] = state.clip[1] = -1.0e9f;
+                        state.clip[2] = state.clip[3] = 1.0e9f;
                 }
-                else if (cmd.type == IMGUI_GFXCMD_TRIANGLE)
+                state.mode = cmd.texture == IMGUI_TEXTURE_WHITE ? INDIRECT_WHITE :
+                             cmd.texture == IMGUI_TEXTURE_FONT ? INDIRECT_FONT : INDIRECT_IMAGE;
+        }
+
+        GL::bindVertexArray(g_mdiVao);
+        GL::bindBuffer(GL::ARRAY_BUFFER, g_mdiBuffers[INDIRECT_VERTICES]);
+        GL::bufferData(GL::ARRAY_BUFFER, g_drawList.vertexCount*sizeof(imguiVertex), g_drawList.vertices, GL::STREAM_DRAW);
+        GL::bindBuffer(GL::ARRAY_BUFFER, g_mdiBuffers[INDIRECT_STATES]);
+        GL::bufferData(GL::ARRAY_BUFFER, n*sizeof(IndirectDrawState), g_mdiStates, GL::STREAM_DRAW);
+        GL::bufferData(GL::ELEMENT_ARRAY_BUFFER, g_drawList.indexCount*sizeof(unsigned short), g_drawList.indices, GL::STREAM_DRAW);
+        GL::bindBuffer(GL::DRAW_INDIRECT_BUFFER, g_mdiBuffers[INDIRECT_COMMANDS]);
+        GL::bufferData(GL::DRAW_INDIRECT_BUFFER, n*sizeof(IndirectCommand), g_mdiCommands, GL::STREAM_DRAW);
+        stats->uploadBytes += (int)(g_drawList.vertexCount*sizeof(imguiVertex) + g_drawList.indexCount*sizeof(unsigned short) +
+                                    n*(sizeof(IndirectDrawState) + sizeof(IndirectCommand)));
+
+        GL::useProgram(g_mdiProgram);
+        GL::uniform2f(g_mdiViewportLocation, (float) width, (float) height);
+        GL::uniform1i(g_mdiTextureLocation, 0);
+
+        // White ranges ignore the texture, so they join either neighbour.
+        unsigned i = 0;
+        GL::UInt bound = 0;
+        while (i < n)
+        {
+                GL::UInt texture = 0;
+                unsigned j = i;
+                for (; j < n; ++j)
                 {
-                        if (cmd.flags == 1)
-                        {
-                                const float verts[3*2] =
-                                {
-                                        (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
-                                        (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s/2-0.5f,
-                                        (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
-                                };
-                                drawPolygon(verts, 3, 1.0f, cmd.col);
-                        }
-                        if (cmd.flags == 2)
-                        {
-                                const float verts[3*2] =
-                                {
-                                        (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
-                                        (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s/2-0.5f, (float)cmd.rect.y*s+0.5f,
-                                        (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
-                                };
-                                drawPolygon(verts, 3, 1.0f, cmd.col);
-                        }
+                        const unsigned int t = g_drawList.cmds[j].texture;
+                        if (t == IMGUI_TEXTURE_WHITE)
+                                continue;
+                        const GL::UInt name = t == IMGUI_TEXTURE_FONT ? g_ftex : t;
+                        if (texture && name != texture)
+                                break;
+                        texture = name;
                 }
-                else if (cmd.type == IMGUI_GFXCMD_TEXT)
+                if (!texture)
+                        texture = bound ? bound : g_ftex;
+                if (texture != bound)
                 {
-                        drawText(cmd.text.x, cmd.text.y, cmd.text.text, cmd.text.align, cmd.col);
+                        GL::bindTexture(GL::TEXTURE_2D, texture);
+                        bound = texture;
+                        stats->textureBinds++;
                 }
-                else if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+                GL::multiDrawElementsIndirect(GL::TRIANGLES, GL::UNSIGNED_SHORT,
+                                              (const void*)(i*sizeof(IndirectCommand)), (GL::Sizei)(j - i), 0);
+                stats->drawCalls++;
+                i = j;
+        }
+
+        GL::bindVertexArray(0);
+        GL::bindBuffer(GL::ARRAY_BUFFER, 0);
+        GL::bindBuffer(GL::DRAW_INDIRECT_BUFFER, 0);
+        return true;
+}
+#endif // IMGUI_GL_DESKTOP
+
+void imguiRenderGLDraw(int width, int height)
+{
+        IMGUI_PROFILE_SCOPE("imguiRenderGLDraw");
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const imguiGfxCmd* q = imguiGetRenderQueue();
+        int nq = imguiGetRenderQueueSize();
+        imguiFrameStats* stats = imguiGetFrameStats();
+
+        IMGUI_PROFILE_BEGIN("tessellate");
+        imguiTessellate(&g_drawList, q, nq);
+        IMGUI_PROFILE_END();
+        stats->vertices += (int)g_drawList.vertexCount;
+        stats->indices += (int)g_drawList.indexCount;
+        stats->batchesSaved += (int)g_drawList.batchesSaved;
+
+        IMGUI_PROFILE_BEGIN("submit");
+#ifdef IMGUI_GL_DESKTOP
+        int query = -1;
+        if (g_gpuTimerSupported)
+        {
+                readGpuQueries();
+                if (!g_gpuQueryPending[g_gpuQueryNext])
                 {
-                        if (cmd.flags)
-                        {
-                                GL::enable(GL::SCISSOR_TEST);
-                                GL::scissor(cmd.rect.x, cmd.rect.y, cmd.rect.w, cmd.rect.h);
-                        }
-                        else
-                        {
-                                GL::disable(GL::SCISSOR_TEST);
-                        }
+                        query = g_gpuQueryNext;
+                        g_gpuQueryNext = (g_gpuQueryNext + 1) % GPU_QUERY_COUNT;
+                        GL::beginQuery(GL::TIME_ELAPSED, g_gpuQueries[query]);
                 }
         }
+#endif
+
+        GL::viewport(0, 0, width, height);
+        GL::enable(GL::BLEND);
+        GL::blendFunc(GL::SRC_ALPHA, GL::ONE_MINUS_SRC_ALPHA);
+        GL::disable(GL::DEPTH_TEST);
         GL::disable(GL::SCISSOR_TEST);
+        GL::activeTexture(GL::TEXTURE0);
+
+#ifdef IMGUI_GL_DESKTOP
+        if (!g_multiDraw || !drawIndirect(width, height, stats))
+                drawDirect(width, height, stats);
+#else
+        drawDirect(width, height, stats);
+#endif
+
+#ifdef IMGUI_GL_DESKTOP
+        if (query >= 0)
+        {
+                GL::endQuery(GL::TIME_ELAPSED);
+                g_gpuQueryPending[query] = true;
+        }
+#endif
+        IMGUI_PROFILE_END();
+
+        stats->renderTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+float imguiRenderGLGetGpuTime()
+{
+        return g_gpuTime;
+}
+
+bool imguiRenderGLSetMultiDrawIndirect(bool enabled)
+{
+#ifdef IMGUI_GL_DESKTOP
+        g_multiDraw = enabled && g_multiDrawSupported;
+        return g_multiDraw;
+#else
+        (void)enabled;
+        return false;
+#endif
 }
@@ -27,5 +27,18 @@
 bool imguiRenderGLInit(Resource::Loader & loader, const std::string & fontpath);
 void imguiRenderGLDestroy();
 void imguiRenderGLDraw(int width, int height);
+// GPU time of a recent imguiRenderGLDraw() in ms, from timer queries read a
+// few frames late so nothing stalls. -1 until a result arrives, or when the
+// context lacks GL_TIME_ELAPSED (GL 3.3 or ARB_timer_query). Always -1
+// unless built with IMGUI_GL_DESKTOP against a desktop GL wrapper; the
+// GLES2 import has no timer queries. The UI draw must not be nested in
+// another GL_TIME_ELAPSED query.
+float imguiRenderGLGetGpuTime();
+// Submits each frame with glMultiDrawElementsIndirect, one call per change
+// between the font and an image, with clip rects applied in the fragment
+// shader. Off by default. Needs GL 4.3, or GL 3.3 with
+// ARB_multi_draw_indirect and ARB_base_instance, and a build with
+// IMGUI_GL_DESKTOP. Returns whether it is in use, false when unsupported.
+bool imguiRenderGLSetMultiDrawIndirect(bool enabled);
 
 #endif // IMGUI_RENDER_GL_H
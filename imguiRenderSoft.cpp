@@ -0,0 +1,1233 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#       define IMGUI_SOFT_SSE2
+#       include <emmintrin.h>
+#endif
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "imguiRenderSoft.h"
+#include "imgui.h"
+#include "imguiInternal.h"
+#include "imguiProfiler.h"
+
+#include <yip-imports/stb_truetype.h>
+
+static const int FONT_TEXTURE_SIZE = 512;
+
+static stbtt_bakedchar g_cdata[96]; // ASCII 32..126 is 95 glyphs
+static unsigned char* g_fontBitmap = 0;
+
+// Shapes are rasterized with analytic coverage. The effective outlines are
+// chosen to match the 1px alpha fringe produced by the GL3 renderer.
+
+struct SoftTarget
+{
+        unsigned int* pixels;
+        int width, height, stride;
+};
+
+struct SoftClip
+{
+        int x0, y0, x1, y1;
+};
+
+inline int mini(int a, int b) { return a < b ? a : b; }
+inline int maxi(int a, int b) { return a > b ? a : b; }
+inline float minf(float a, float b) { return a < b ? a : b; }
+inline float maxf(float a, float b) { return a > b ? a : b; }
+
+inline int coverageAlpha(unsigned int col, float cov)
+{
+        if (cov <= 0.0f) return 0;
+        if (cov >= 1.0f) return (int)(col >> 24);
+        return (int)((float)(col >> 24) * cov + 0.5f);
+}
+
+// Straight src-over blend: rgb = src*a + dst*(1-a), alpha = a + dst*(1-a).
+// Both reduce to the same expression when the source alpha channel is
+// treated as 255.
+inline unsigned int div255(unsigned int t)
+{
+        t += 128;
+        return (t + (t >> 8)) >> 8;
+}
+
+inline void blendPixel(unsigned int* dst, unsigned int col, int a)
+{
+        if (a <= 0) return;
+        const unsigned int d = *dst;
+        const unsigned int ia = 255 - a;
+        const unsigned int r = div255((col & 0xff)*a + (d & 0xff)*ia);
+        const unsigned int g = div255(((col >> 8) & 0xff)*a + ((d >> 8) & 0xff)*ia);
+        const unsigned int b = div255(((col >> 16) & 0xff)*a + ((d >> 16) & 0xff)*ia);
+        const unsigned int da = div255(255*a + (d >> 24)*ia);
+        *dst = r | (g << 8) | (b << 16) | (da << 24);
+}
+
+static void blendSpan(unsigned int* dst, int n, unsigned int col, int a)
+{
+        if (a <= 0 || n <= 0) return;
+        if (a >= 255)
+        {
+                const unsigned int c = col | 0xff000000;
+                for (int i = 0; i < n; ++i)
+                        dst[i] = c;
+                return;
+        }
+        int i = 0;
+#ifdef IMGUI_SOFT_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i src = _mm_unpacklo_epi8(_mm_set1_epi32((int)(col | 0xff000000)), zero);
+        const __m128i srcA = _mm_mullo_epi16(src, _mm_set1_epi16((short)a));
+        const __m128i invA = _mm_set1_epi16((short)(255 - a));
+        const __m128i round = _mm_set1_epi16(128);
+        for (; i+4 <= n; i += 4)
+        {
+                __m128i d = _mm_loadu_si128((const __m128i*)(dst+i));
+                __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), invA), srcA), round);
+                __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), invA), srcA), round);
+                lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+                hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+                _mm_storeu_si128((__m128i*)(dst+i), _mm_packus_epi16(lo, hi));
+        }
+#endif
+        for (; i < n; ++i)
+                blendPixel(dst+i, col, a);
+}
+
+// Fills a box [x0,x1]x[y0,y1] with corner radius r. Rows are split into an
+// edge zone evaluated per pixel and a middle span of constant coverage.
+static void fillRoundedBox(const SoftTarget& t, const SoftClip& clip,
+                           float x0, float y0, float x1, float y1, float r, unsigned int col)
+{
+        if (x1 <= x0 || y1 <= y0) return;
+        r = minf(r, minf(x1-x0, y1-y0)*0.5f);
+        if (r < 0) r = 0;
+
+        const float cx = (x0+x1)*0.5f;
+        const float cy = (y0+y1)*0.5f;
+        const float hx = (x1-x0)*0.5f - r;
+        const float hy = (y1-y0)*0.5f - r;
+
+        const int ry0 = maxi(clip.y0, (int)floorf(y0 - 0.5f));
+        const int ry1 = mini(clip.y1, (int)ceilf(y1 + 0.5f));
+        const int rx0 = maxi(clip.x0, (int)floorf(x0 - 0.5f));
+        const int rx1 = mini(clip.x1, (int)ceilf(x1 + 0.5f));
+        if (rx0 >= rx1) return;
+
+        for (int py = ry0; py < ry1; ++py)
+        {
+                const float yc = (float)py + 0.5f;
+                const float qy = fabsf(yc - cy) - hy;
+                const float covY = 0.5f - (qy - r);
+                if (covY <= 0.0f) continue;
+
+                // Columns whose coverage only depends on the row.
+                const float m = maxf(0.5f, qy > 0 ? r : 0.0f);
+                const int mx0 = maxi(rx0, (int)ceilf(x0 + m - 0.5f));
+                const int mx1 = mini(rx1, (int)floorf(x1 - m - 0.5f) + 1);
+
+                unsigned int* row = t.pixels + py*t.stride;
+                for (int px = rx0; px < rx1; ++px)
+                {
+                        if (px == mx0 && mx1 > mx0)
+                        {
+                                blendSpan(row + mx0, mx1 - mx0, col, coverageAlpha(col, covY));
+                                px = mx1 - 1;
+                                continue;
+                        }
+                        const float xc = (float)px + 0.5f;
+                        const float qx = fabsf(xc - cx) - hx;
+                        float sd;
+                        if (qx > 0 && qy > 0)
+                                sd = sqrtf(qx*qx + qy*qy) - r;
+                        else
+                                sd = maxf(qx, qy) - r;
+                        blendPixel(row + px, col, coverageAlpha(col, 0.5f - sd));
+                }
+        }
+}
+
+// Signed distance to an ellipse around the origin: exact for circles, a
+// first order estimate otherwise.
+inline float ellipseDistance(float x, float y, float rx, float ry)
+{
+        if (rx == ry)
+                return sqrtf(x*x + y*y) - rx;
+        const float ax = x/rx, ay = y/ry;
+        const float k0 = sqrtf(ax*ax + ay*ay);
+        const float k1 = sqrtf(ax*ax/(rx*rx) + ay*ay/(ry*ry));
+        return k1 > 0 ? k0*(k0 - 1.0f)/k1 : -minf(rx, ry);
+}
+
+// Half width of the row 'dy' from the center through an ellipse, or -1.
+inline float ellipseSpan(float dy, float rx, float ry)
+{
+        if (rx <= 0 || ry <= 0) return -1.0f;
+        const float e = dy/ry;
+        return e*e < 1.0f ? rx*sqrtf(1.0f - e*e) : -1.0f;
+}
+
+// Fills the ellipse of radii rx, ry around (cx, cy), or the ring between it
+// and the ellipse 'stroke' smaller. Rows blend the span inside the ellipse
+// shrunk by a pixel at full coverage, skip the ring's hole, and evaluate the
+// distance for the pixels in between.
+static void fillEllipse(const SoftTarget& t, const SoftClip& clip,
+                        float cx, float cy, float rx, float ry, float stroke, unsigned int col)
+{
+        if (rx <= 0.5f || ry <= 0.5f) return;
+        const bool ring = stroke > 0 && stroke < minf(rx, ry);
+        const int ry0 = maxi(clip.y0, (int)floorf(cy - ry - 1.0f));
+        const int ry1 = mini(clip.y1, (int)ceilf(cy + ry + 1.0f));
+        const int alpha = (int)(col >> 24);
+
+        for (int py = ry0; py < ry1; ++py)
+        {
+                const float dy = (float)py + 0.5f - cy;
+                const float ox = ellipseSpan(dy, rx + 1.0f, ry + 1.0f);
+                if (ox < 0) continue;
+                const int px0 = maxi(clip.x0, (int)floorf(cx - ox));
+                const int px1 = mini(clip.x1, (int)ceilf(cx + ox));
+
+                const float sx = ring ? -1.0f : ellipseSpan(dy, rx - 1.0f, ry - 1.0f);
+                const float hx = ring ? ellipseSpan(dy, rx - stroke - 1.0f, ry - stroke - 1.0f) : -1.0f;
+                int fx0 = px1, fx1 = px1, hx0 = px1, hx1 = px1;
+                if (sx >= 0)
+                {
+                        fx0 = maxi(px0, (int)ceilf(cx - sx - 0.5f));
+                        fx1 = mini(px1, (int)floorf(cx + sx - 0.5f) + 1);
+                }
+                if (hx >= 0)
+                {
+                        hx0 = maxi(px0, (int)ceilf(cx - hx - 0.5f));
+                        hx1 = mini(px1, (int)floorf(cx + hx - 0.5f) + 1);
+                }
+
+                unsigned int* row = t.pixels + py*t.stride;
+                for (int px = px0; px < px1; ++px)
+                {
+                        if (px == fx0 && fx1 > fx0)
+                        {
+                                blendSpan(row + fx0, fx1 - fx0, col, alpha);
+                                px = fx1 - 1;
+                                continue;
+                        }
+                        if (px == hx0 && hx1 > hx0)
+                        {
+                                px = hx1 - 1;
+                                continue;
+                        }
+                        float sd = ellipseDistance((float)px + 0.5f - cx, dy, rx, ry);
+                        if (ring)
+                                sd = maxf(sd, -ellipseDistance((float)px + 0.5f - cx, dy, rx - stroke, ry - stroke));
+                        blendPixel(row + px, col, coverageAlpha(col, 0.5f - sd));
+                }
+        }
+}
+
+// Circle too small for a solid core, as the GL fringe draws it: coverage
+// falls from the center to zero a pixel out, scaled by the circle's area.
+static void fillDot(const SoftTarget& t, const SoftClip& clip, float cx, float cy, float r, unsigned int col)
+{
+        if (r <= 0.0f) return;
+        const float scale = minf(r*r*4.0f, 1.0f);
+        const int px0 = maxi(clip.x0, (int)floorf(cx - 1.0f));
+        const int px1 = mini(clip.x1, (int)ceilf(cx + 1.0f));
+        const int py0 = maxi(clip.y0, (int)floorf(cy - 1.0f));
+        const int py1 = mini(clip.y1, (int)ceilf(cy + 1.0f));
+        for (int py = py0; py < py1; ++py)
+        {
+                unsigned int* row = t.pixels + py*t.stride;
+                const float dy = (float)py + 0.5f - cy;
+                for (int px = px0; px < px1; ++px)
+                {
+                        const float dx = (float)px + 0.5f - cx;
+                        const float d = sqrtf(dx*dx + dy*dy);
+                        if (d < 1.0f)
+                                blendPixel(row + px, col, coverageAlpha(col, (1.0f - d)*scale));
+                }
+        }
+}
+
+// Fills a convex polygon grown by 'expand'. Coverage is derived from the
+// distance to the nearest edge, which matches the mitered GL fringe. Edges
+// whose bit is set in 'hardEdges' (edge i ends at point i) are not grown
+// nor anti-aliased, so pieces sharing them tile without overlap.
+static void fillConvex(const SoftTarget& t, const SoftClip& clip,
+                       const float* pts, int npts, float expand, unsigned int col,
+                       unsigned hardEdges = 0)
+{
+        static const int MAX_EDGES = 16;
+        float nx[MAX_EDGES], ny[MAX_EDGES], nc[MAX_EDGES];
+        bool hard[MAX_EDGES];
+        if (npts > MAX_EDGES) npts = MAX_EDGES;
+
+        float area = 0;
+        for (int i = 0, j = npts-1; i < npts; j = i++)
+                area += pts[j*2]*pts[i*2+1] - pts[i*2]*pts[j*2+1];
+        const float orient = area < 0 ? -1.0f : 1.0f;
+
+        int nedges = 0;
+        float bx0 = pts[0], by0 = pts[1], bx1 = pts[0], by1 = pts[1];
+        for (int i = 0, j = npts-1; i < npts; j = i++)
+        {
+                bx0 = minf(bx0, pts[i*2]); bx1 = maxf(bx1, pts[i*2]);
+                by0 = minf(by0, pts[i*2+1]); by1 = maxf(by1, pts[i*2+1]);
+                const float dx = pts[i*2] - pts[j*2];
+                const float dy = pts[i*2+1] - pts[j*2+1];
+                const float d = sqrtf(dx*dx + dy*dy);
+                if (d < 0.0001f) continue;
+                hard[nedges] = ((hardEdges >> i) & 1) != 0;
+                nx[nedges] = orient*dy/d;
+                ny[nedges] = -orient*dx/d;
+                nc[nedges] = nx[nedges]*pts[j*2] + ny[nedges]*pts[j*2+1] + (hard[nedges] ? 0.0f : expand);
+                nedges++;
+        }
+        if (nedges < 3) return;
+
+        const int ry0 = maxi(clip.y0, (int)floorf(by0 - expand - 0.5f));
+        const int ry1 = mini(clip.y1, (int)ceilf(by1 + expand + 0.5f));
+        const int rx0 = maxi(clip.x0, (int)floorf(bx0 - expand - 0.5f));
+        const int rx1 = mini(clip.x1, (int)ceilf(bx1 + expand + 0.5f));
+        if (rx0 >= rx1) return;
+
+        const int alpha = (int)(col >> 24);
+        for (int py = ry0; py < ry1; ++py)
+        {
+                const float yc = (float)py + 0.5f;
+
+                // Intersect the edge half-planes along the row, once for
+                // pixels with any coverage and once for fully covered ones.
+                float lo = -1e30f, hi = 1e30f, flo = -1e30f, fhi = 1e30f;
+                for (int e = 0; e < nedges; ++e)
+                {
+                        const float rhs = nc[e] - ny[e]*yc;
+                        const float ramp = hard[e] ? 0.0f : 0.5f;
+                        if (nx[e] > 0.0001f)
+                        {
+                                hi = minf(hi, (rhs + ramp)/nx[e]);
+                                fhi = minf(fhi, (rhs - ramp)/nx[e]);
+                        }
+                        else if (nx[e] < -0.0001f)
+                        {
+                                lo = maxf(lo, (rhs + ramp)/nx[e]);
+                                flo = maxf(flo, (rhs - ramp)/nx[e]);
+                        }
+                        else
+                        {
+                                if (rhs + ramp < 0) hi = lo - 1;
+                                if (rhs - ramp < 0) fhi = flo - 1;
+                        }
+                }
+                if (lo > hi) continue;
+
+                const int px0 = maxi(rx0, (int)floorf(lo - 0.5f));
+                const int px1 = mini(rx1, (int)ceilf(hi - 0.5f) + 1);
+                int fx0 = px1, fx1 = px1;
+                if (flo <= fhi)
+                {
+                        fx0 = maxi(px0, (int)ceilf(flo - 0.5f));
+                        fx1 = mini(px1, (int)floorf(fhi - 0.5f) + 1);
+                        if (fx1 < fx0) fx0 = fx1 = px1;
+                }
+
+                unsigned int* row = t.pixels + py*t.stride;
+                for (int px = px0; px < px1; ++px)
+                {
+                        if (px == fx0 && fx1 > fx0)
+                        {
+                                blendSpan(row + fx0, fx1 - fx0, col, alpha);
+                                px = fx1 - 1;
+                                continue;
+                        }
+                        const float xc = (float)px + 0.5f;
+                        float sd = -1e30f;
+                        bool outside = false;
+                        for (int e = 0; e < nedges; ++e)
+                        {
+                                const float de = nx[e]*xc + ny[e]*yc - nc[e];
+                                if (!hard[e])
+                                        sd = maxf(sd, de);
+                                else if (de > 0)
+                                        outside = true;
+                        }
+                        if (outside) continue;
+                        blendPixel(row + px, col, coverageAlpha(col, 0.5f - sd));
+                }
+        }
+}
+
+static void drawLine(const SoftTarget& t, const SoftClip& clip,
+                     float x0, float y0, float x1, float y1, float r, float fth, unsigned int col)
+{
+        float dx = x1-x0;
+        float dy = y1-y0;
+        float d = sqrtf(dx*dx+dy*dy);
+        if (d > 0.0001f)
+        {
+                d = 1.0f/d;
+                dx *= d;
+                dy *= d;
+        }
+        float nx = dy;
+        float ny = -dx;
+        r -= fth;
+        r *= 0.5f;
+        if (r < 0.01f) r = 0.01f;
+        dx *= r;
+        dy *= r;
+        nx *= r;
+        ny *= r;
+
+        const float verts[4*2] =
+        {
+                x0-dx-nx, y0-dy-ny,
+                x0-dx+nx, y0-dy+ny,
+                x1+dx+nx, y1+dy+ny,
+                x1+dx-nx, y1+dy-ny,
+        };
+        fillConvex(t, clip, verts, 4, fth*0.5f, col);
+}
+
+// Polylines are filled piece by piece: a quad per segment between the
+// cross-sections at its ends and a quad per beveled corner. The joins come
+// from imguiInternal.h, shared with the GL tessellation.
+
+// Quad between two cross-sections. Both are hard edges unless they are
+// end caps, so consecutive pieces do not blend twice along them.
+static void fillSections(const SoftTarget& t, const SoftClip& clip,
+                         float x0, float y0, const imguiStrokeSection& s0, bool cap0,
+                         float x1, float y1, const imguiStrokeSection& s1, bool cap1,
+                         float hw, float fth, unsigned int col)
+{
+        const float verts[4*2] =
+        {
+                x0 - s0.bx*hw, y0 - s0.by*hw,
+                x0 + s0.ax*hw, y0 + s0.ay*hw,
+                x1 + s1.ax*hw, y1 + s1.ay*hw,
+                x1 - s1.bx*hw, y1 - s1.by*hw,
+        };
+        fillConvex(t, clip, verts, 4, fth*0.5f, col, (cap0 ? 0u : 2u) | (cap1 ? 0u : 8u));
+}
+
+static void drawPolyline(const SoftTarget& t, const SoftClip& clip,
+                         const short* pts, unsigned n, float r, int flags, unsigned int col)
+{
+        if (!pts || n < 2) return;
+
+        const bool closed = (flags & IMGUI_POLYLINE_CLOSED) && n > 2;
+        const bool bevel = (flags & IMGUI_POLYLINE_BEVEL) != 0;
+        const unsigned m = closed ? n+1 : n;
+        const unsigned nsegs = m-1;
+        const float s = 1.0f/8.0f;
+        const float fth = 1.0f;
+        float hw = (r - fth)*0.5f;
+        if (hw < 0.01f) hw = 0.01f;
+
+        // Points whose next segment has no length are skipped, the next
+        // point being at the same place. A closed path starts with the last
+        // segment with any length coming into it and ends on its first one.
+        float seg0[3] = { 0, 0, 0 }, seg1[3] = { 0, 0, 0 }, firstSeg[3] = { 0, 0, 0 };
+        for (unsigned k = nsegs; closed && k-- > 0 && seg0[2] == 0;)
+                imguiPolylineSegment(pts, k % n, (k+1) % n, seg0);
+        for (unsigned k = 0; closed && k < nsegs && firstSeg[2] == 0; ++k)
+                imguiPolylineSegment(pts, k % n, (k+1) % n, firstSeg);
+
+        imguiStrokeSection prev = { 0, 0, 0, 0 }, sec[2];
+        float px = 0, py = 0;
+        bool started = false, prevCap = false;
+        for (unsigned i = 0; i < m; ++i)
+        {
+                if (i < nsegs)
+                {
+                        imguiPolylineSegment(pts, i % n, (i+1) % n, seg1);
+                        if (seg1[2] == 0)
+                                continue;
+                }
+                else if (closed)
+                {
+                        memcpy(seg1, firstSeg, sizeof(seg1));
+                }
+                else if (!started)
+                {
+                        return;
+                }
+
+                float x = pts[(i % n)*2]*s;
+                float y = pts[(i % n)*2+1]*s;
+                int ns = 1;
+                if (!closed && (!started || i == m-1))
+                {
+                        const float* d = started ? seg0 : seg1;
+                        const float sign = started ? 1.0f : -1.0f;
+                        x += sign*d[0]*hw;
+                        y += sign*d[1]*hw;
+                        sec[0].ax = sec[0].bx = d[1];
+                        sec[0].ay = sec[0].by = -d[0];
+                }
+                else
+                {
+                        ns = imguiJoinSections(seg0, seg1, hw + fth, bevel, sec);
+                }
+
+                const bool cap = !closed && (!started || i == m-1);
+                if (started)
+                {
+                        fillSections(t, clip, px, py, prev, prevCap, x, y, sec[0], cap, hw, fth, col);
+                        if (ns == 2)
+                                fillSections(t, clip, x, y, sec[0], false, x, y, sec[1], false, hw, fth, col);
+                }
+                prevCap = cap;
+                prev = sec[ns-1];
+                px = x;
+                py = y;
+                started = true;
+                memcpy(seg0, seg1, sizeof(seg0));
+        }
+}
+
+// Fills between the edges of a band column by column. Vertical coverage is
+// the overlap of each pixel with the interpolated [bottom, top] range.
+static void fillBand(const SoftTarget& t, const SoftClip& clip,
+                     const short* pts, unsigned n, unsigned int col)
+{
+        n /= 2;
+        if (!pts || n < 2) return;
+
+        const float s = 1.0f/8.0f;
+        const float xa = pts[0]*s;
+        const float xb = pts[(n-1)*4]*s;
+        const int px0 = maxi(clip.x0, (int)floorf(xa));
+        const int px1 = mini(clip.x1, (int)ceilf(xb));
+
+        unsigned seg = 0;
+        for (int px = px0; px < px1; ++px)
+        {
+                const float xc = (float)px + 0.5f;
+                if (xc < xa || xc > xb) continue;
+                while (seg+2 < n && pts[(seg+1)*4]*s < xc)
+                        seg++;
+
+                const short* a = pts + seg*4;
+                const short* b = a + 4;
+                const float x0 = a[0]*s, x1 = b[0]*s;
+                float u = x1 > x0 ? (xc - x0)/(x1 - x0) : 0.0f;
+                u = minf(maxf(u, 0.0f), 1.0f);
+                float lo = (a[1] + (b[1] - a[1])*u)*s;
+                float hi = (a[3] + (b[3] - a[3])*u)*s;
+                if (lo > hi)
+                {
+                        const float tmp = lo;
+                        lo = hi;
+                        hi = tmp;
+                }
+
+                const int py0 = maxi(clip.y0, (int)floorf(lo));
+                const int py1 = mini(clip.y1, (int)ceilf(hi));
+                for (int py = py0; py < py1; ++py)
+                {
+                        const float cov = minf(hi, (float)py + 1.0f) - maxf(lo, (float)py);
+                        blendPixel(t.pixels + py*t.stride + px, col, coverageAlpha(col, cov));
+                }
+        }
+}
+
+// Textures registered for image commands. Pixels are referenced, not copied.
+struct SoftTexture
+{
+        unsigned int handle;
+        const unsigned int* pixels;
+        int width, height, stride;
+};
+
+static const int MAX_TEXTURES = 64;
+static SoftTexture g_textures[MAX_TEXTURES];
+static int g_textureCount = 0;
+
+static const SoftTexture* findTexture(unsigned int handle)
+{
+        for (int i = 0; i < g_textureCount; ++i)
+                if (g_textures[i].handle == handle)
+                        return &g_textures[i];
+        return 0;
+}
+
+// Maps the texel rect (u0, v0) - (u1, v1) onto [x0,x1]x[y0,y1] with nearest
+// sampling. v0 is at the top edge, y1.
+static void fillImage(const SoftTarget& t, const SoftClip& clip, const SoftTexture& tex,
+                      float x0, float y0, float x1, float y1, float u0, float v0, float u1, float v1)
+{
+        if (x1 <= x0 || y1 <= y0) return;
+        const int px0 = maxi(clip.x0, (int)ceilf(x0 - 0.5f));
+        const int px1 = mini(clip.x1, (int)ceilf(x1 - 0.5f));
+        const int py0 = maxi(clip.y0, (int)ceilf(y0 - 0.5f));
+        const int py1 = mini(clip.y1, (int)ceilf(y1 - 0.5f));
+        const float du = (u1 - u0)*(float)tex.width/(x1 - x0);
+        const float dv = (v0 - v1)*(float)tex.height/(y1 - y0);
+
+        for (int py = py0; py < py1; ++py)
+        {
+                const int ty = mini(tex.height-1, maxi(0, (int)(v1*(float)tex.height + ((float)py + 0.5f - y0)*dv)));
+                const unsigned int* src = tex.pixels + ty*tex.stride;
+                unsigned int* row = t.pixels + py*t.stride;
+                for (int px = px0; px < px1; ++px)
+                {
+                        const int tx = mini(tex.width-1, maxi(0, (int)(u0*(float)tex.width + ((float)px + 0.5f - x0)*du)));
+                        const unsigned int c = src[tx];
+                        blendPixel(row + px, c, (int)(c >> 24));
+                }
+        }
+}
+
+static void getBakedQuad(stbtt_bakedchar *chardata, int pw, int ph, int char_index,
+                                                 float *xpos, float *ypos, stbtt_aligned_quad *q)
+{
+        stbtt_bakedchar *b = chardata + char_index;
+        int round_x = (int)floor(*xpos + b->xoff);
+        int round_y = (int)floor(*ypos - b->yoff);
+
+        q->x0 = (float)round_x;
+        q->y0 = (float)round_y;
+        q->x1 = (float)round_x + b->x1 - b->x0;
+        q->y1 = (float)round_y - b->y1 + b->y0;
+
+        q->s0 = b->x0 / (float)pw;
+        q->t0 = b->y0 / (float)pw;
+        q->s1 = b->x1 / (float)ph;
+        q->t1 = b->y1 / (float)ph;
+
+        *xpos += b->xadvance;
+}
+
+static float getTextLength(stbtt_bakedchar *chardata, const char* text)
+{
+        const imguiBakedGlyphs<stbtt_bakedchar> glyphs = { chardata };
+        return imguiTextWidth(text, glyphs);
+}
+
+static void drawText(const SoftTarget& t, const SoftClip& clip,
+                     float x, float y, const char *text, int align, unsigned int col)
+{
+        if (!g_fontBitmap) return;
+        if (!text) return;
+
+        if (align == IMGUI_ALIGN_CENTER)
+                x -= getTextLength(g_cdata, text)/2;
+        else if (align == IMGUI_ALIGN_RIGHT)
+                x -= getTextLength(g_cdata, text);
+
+        const int alpha = (int)(col >> 24);
+        const float ox = x;
+
+        while (*text)
+        {
+                int c = (unsigned char)*text;
+                if (c == '\t')
+                {
+                        x = ox + imguiNextTabStop(x - ox);
+                }
+                else if (c >= 32 && c < 128)
+                {
+                        const stbtt_bakedchar* b = g_cdata + c-32;
+                        stbtt_aligned_quad q;
+                        getBakedQuad(g_cdata, FONT_TEXTURE_SIZE, FONT_TEXTURE_SIZE, c-32, &x, &y, &q);
+
+                        // The glyph spans rows [y1,y0) with texel row b->y0 on top.
+                        const int gx0 = (int)q.x0;
+                        const int gy1 = (int)q.y0;
+                        const int cx0 = maxi(clip.x0, gx0);
+                        const int cx1 = mini(clip.x1, (int)q.x1);
+                        const int cy0 = maxi(clip.y0, (int)q.y1);
+                        const int cy1 = mini(clip.y1, gy1);
+                        for (int py = cy0; py < cy1; ++py)
+                        {
+                                const unsigned char* src = g_fontBitmap + (b->y0 + gy1-1-py)*FONT_TEXTURE_SIZE + b->x0;
+                                unsigned int* row = t.pixels + py*t.stride;
+                                for (int px = cx0; px < cx1; ++px)
+                                {
+                                        const unsigned int g = src[px - gx0];
+                                        if (g)
+                                                blendPixel(row + px, col, (int)div255(g*alpha));
+                                }
+                        }
+                }
+                ++text;
+        }
+}
+
+static void drawCommand(const SoftTarget& t, const SoftClip& clip, const imguiGfxCmd& cmd)
+{
+        const float s = 1.0f/8.0f;
+
+        if (cmd.type == IMGUI_GFXCMD_RECT)
+        {
+                const float x = (float)cmd.rect.x*s;
+                const float y = (float)cmd.rect.y*s;
+                const float w = (float)cmd.rect.w*s;
+                const float h = (float)cmd.rect.h*s;
+                if (cmd.rect.r == 0)
+                        fillRoundedBox(t, clip, x+0.5f, y+0.5f, x+w-0.5f, y+h-0.5f, 0.0f, cmd.col);
+                else
+                        fillRoundedBox(t, clip, x, y, x+w, y+h, (float)cmd.rect.r*s+0.5f, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_LINE)
+        {
+                drawLine(t, clip, cmd.line.x0*s, cmd.line.y0*s, cmd.line.x1*s, cmd.line.y1*s, cmd.line.r*s, 1.0f, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TRIANGLE)
+        {
+                if (cmd.flags == 1)
+                {
+                        const float verts[3*2] =
+                        {
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s/2-0.5f,
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                        };
+                        fillConvex(t, clip, verts, 3, 0.5f, cmd.col);
+                }
+                if (cmd.flags == 2)
+                {
+                        const float verts[3*2] =
+                        {
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s/2-0.5f, (float)cmd.rect.y*s+0.5f,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                        };
+                        fillConvex(t, clip, verts, 3, 0.5f, cmd.col);
+                }
+        }
+        else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+        {
+                if (cmd.flags & IMGUI_POLYLINE_BAND)
+                {
+                        fillBand(t, clip, cmd.poly.points, cmd.poly.count, cmd.col);
+                }
+                else if (cmd.flags & IMGUI_POLYLINE_MARKERS)
+                {
+                        const float r = cmd.poly.r*s;
+                        for (unsigned i = 0; cmd.poly.points && i < cmd.poly.count; ++i)
+                        {
+                                const float cx = cmd.poly.points[i*2]*s, cy = cmd.poly.points[i*2+1]*s;
+                                if (r <= 0.5f)
+                                        fillDot(t, clip, cx, cy, r, cmd.col);
+                                else
+                                        fillEllipse(t, clip, cx, cy, r, r, 0.0f, cmd.col);
+                        }
+                }
+                else
+                {
+                        drawPolyline(t, clip, cmd.poly.points, cmd.poly.count, cmd.poly.r*s, cmd.flags, cmd.col);
+                }
+        }
+        else if (cmd.type == IMGUI_GFXCMD_ELLIPSE)
+        {
+                const float rx = (float)cmd.rect.w*s*0.5f;
+                const float ry = (float)cmd.rect.h*s*0.5f;
+                fillEllipse(t, clip, (float)cmd.rect.x*s + rx, (float)cmd.rect.y*s + ry, rx, ry, (float)cmd.rect.r*s, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                drawText(t, clip, cmd.text.x, cmd.text.y, cmd.text.text, cmd.text.align, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                const SoftTexture* tex = findTexture(cmd.col);
+                if (!tex) return;
+                const float x = (float)cmd.image.x*s;
+                const float y = (float)cmd.image.y*s;
+                const float u = 1.0f/65535.0f;
+                fillImage(t, clip, *tex, x, y, x + (float)cmd.image.w*s, y + (float)cmd.image.h*s,
+                          cmd.image.u0*u, cmd.image.v0*u, cmd.image.u1*u, cmd.image.v1*u);
+        }
+}
+
+static void setScissor(SoftClip& clip, const imguiGfxCmd& cmd, int width, int height)
+{
+        if (cmd.flags)
+        {
+                clip.x0 = maxi(0, cmd.rect.x);
+                clip.y0 = maxi(0, cmd.rect.y);
+                clip.x1 = mini(width, cmd.rect.x + cmd.rect.w);
+                clip.y1 = mini(height, cmd.rect.y + cmd.rect.h);
+        }
+        else
+        {
+                clip.x0 = 0;
+                clip.y0 = 0;
+                clip.x1 = width;
+                clip.y1 = height;
+        }
+}
+
+void imguiRenderSoftDraw(unsigned int* pixels, int width, int height, int stride)
+{
+        IMGUI_PROFILE_SCOPE("imguiRenderSoftDraw");
+        const imguiGfxCmd* q = imguiGetRenderQueue();
+        int nq = imguiGetRenderQueueSize();
+
+        SoftTarget t = { pixels, width, height, stride };
+        SoftClip clip = { 0, 0, width, height };
+
+        for (int i = 0; i < nq; ++i)
+        {
+                const imguiGfxCmd& cmd = q[i];
+                if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+                        setScissor(clip, cmd, width, height);
+                else
+                        drawCommand(t, clip, cmd);
+        }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tiled rendering. Commands are binned into screen tiles by their bounds
+// and scissor, then tiles are rasterized in parallel. Each tile draws its
+// commands in queue order.
+
+static const int TILE_SIZE = 64;
+
+struct TileEntry
+{
+        unsigned int cmd;
+        unsigned int clip;
+};
+
+static SoftClip* g_cmdBounds = 0;
+static unsigned g_cmdBoundsCapacity = 0;
+static SoftClip* g_tileClips = 0;
+static unsigned g_tileClipsCapacity = 0;
+static unsigned* g_tileStart = 0;
+static unsigned g_tileStartCapacity = 0;
+static TileEntry* g_tileEntries = 0;
+static unsigned g_tileEntriesCapacity = 0;
+
+static float g_fontAscent = 0;
+static float g_fontDescent = 0;
+
+// Conservative pixel bounds of a command, before clipping.
+static SoftClip getCommandBounds(const imguiGfxCmd& cmd)
+{
+        const float s = 1.0f/8.0f;
+        float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        if (cmd.type == IMGUI_GFXCMD_RECT || cmd.type == IMGUI_GFXCMD_TRIANGLE || cmd.type == IMGUI_GFXCMD_ELLIPSE)
+        {
+                x0 = cmd.rect.x*s;
+                y0 = cmd.rect.y*s;
+                x1 = x0 + cmd.rect.w*s;
+                y1 = y0 + cmd.rect.h*s;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_LINE)
+        {
+                const float r = cmd.line.r*s;
+                x0 = minf(cmd.line.x0, cmd.line.x1)*s - r;
+                y0 = minf(cmd.line.y0, cmd.line.y1)*s - r;
+                x1 = maxf(cmd.line.x0, cmd.line.x1)*s + r;
+                y1 = maxf(cmd.line.y0, cmd.line.y1)*s + r;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_POLYLINE && cmd.poly.points && cmd.poly.count > 0)
+        {
+                const short* p = cmd.poly.points;
+                // Miters reach 4 half widths of the stroke and its fringe.
+                const float r = cmd.poly.r*s*2.0f + 2.0f;
+                x0 = x1 = p[0]*s;
+                y0 = y1 = p[1]*s;
+                for (unsigned i = 1; i < cmd.poly.count; ++i)
+                {
+                        x0 = minf(x0, p[i*2]*s);
+                        x1 = maxf(x1, p[i*2]*s);
+                        y0 = minf(y0, p[i*2+1]*s);
+                        y1 = maxf(y1, p[i*2+1]*s);
+                }
+                x0 -= r;
+                y0 -= r;
+                x1 += r;
+                y1 += r;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                x0 = cmd.image.x*s;
+                y0 = cmd.image.y*s;
+                x1 = x0 + cmd.image.w*s;
+                y1 = y0 + cmd.image.h*s;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TEXT && cmd.text.text && g_fontBitmap)
+        {
+                const float len = getTextLength(g_cdata, cmd.text.text);
+                x0 = cmd.text.x;
+                if (cmd.text.align == IMGUI_ALIGN_CENTER)
+                        x0 -= len/2;
+                else if (cmd.text.align == IMGUI_ALIGN_RIGHT)
+                        x0 -= len;
+                x1 = x0 + len;
+                y0 = cmd.text.y - g_fontDescent;
+                y1 = cmd.text.y + g_fontAscent;
+        }
+        SoftClip b = { (int)floorf(x0) - 2, (int)floorf(y0) - 2, (int)ceilf(x1) + 2, (int)ceilf(y1) + 2 };
+        return b;
+}
+
+struct TileJob
+{
+        SoftTarget target;
+        const imguiGfxCmd* queue;
+        int tilesX, tileCount;
+        std::atomic<int> next;
+        std::atomic<int> done;
+};
+
+static void rasterizeTiles(TileJob& job)
+{
+        for (;;)
+        {
+                const int tile = job.next.fetch_add(1);
+                if (tile >= job.tileCount)
+                        break;
+                const int tx = (tile % job.tilesX) * TILE_SIZE;
+                const int ty = (tile / job.tilesX) * TILE_SIZE;
+                for (unsigned i = g_tileStart[tile]; i < g_tileStart[tile+1]; ++i)
+                {
+                        const TileEntry& e = g_tileEntries[i];
+                        const SoftClip& c = g_tileClips[e.clip];
+                        SoftClip clip = { maxi(c.x0, tx), maxi(c.y0, ty),
+                                          mini(c.x1, tx + TILE_SIZE), mini(c.y1, ty + TILE_SIZE) };
+                        drawCommand(job.target, clip, job.queue[e.cmd]);
+                }
+                job.done.fetch_add(1);
+        }
+}
+
+// Persistent worker pool. Workers sleep until a new job generation is posted.
+// The pool is a fixed array so drawing never touches the heap.
+static const int MAX_WORKERS = 64;
+static std::thread g_workers[MAX_WORKERS];
+static int g_workerCount = 0;
+static std::mutex g_workerMutex;
+static std::condition_variable g_workerWake;
+static std::condition_variable g_workerDone;
+static TileJob* g_workerJob = 0;
+static unsigned g_workerGeneration = 0;
+static int g_workersBusy = 0;
+static bool g_workerQuit = false;
+
+static void workerMain()
+{
+        unsigned generation = 0;
+        for (;;)
+        {
+                TileJob* job = 0;
+                {
+                        std::unique_lock<std::mutex> lock(g_workerMutex);
+                        g_workerWake.wait(lock, [&] { return g_workerQuit || g_workerGeneration != generation; });
+                        if (g_workerQuit)
+                                return;
+                        generation = g_workerGeneration;
+                        job = g_workerJob;
+                        if (!job)
+                                continue;
+                        g_workersBusy++;
+                }
+                rasterizeTiles(*job);
+                {
+                        std::lock_guard<std::mutex> lock(g_workerMutex);
+                        g_workersBusy--;
+                }
+                g_workerDone.notify_all();
+        }
+}
+
+static void stopWorkers()
+{
+        {
+                std::lock_guard<std::mutex> lock(g_workerMutex);
+                g_workerQuit = true;
+        }
+        g_workerWake.notify_all();
+        for (int i = 0; i < g_workerCount; ++i)
+                g_workers[i].join();
+        g_workerCount = 0;
+        g_workerQuit = false;
+}
+
+static void startWorkers(int count)
+{
+        if (g_workerCount == count)
+                return;
+        stopWorkers();
+        for (int i = 0; i < count; ++i)
+                g_workers[i] = std::thread(workerMain);
+        g_workerCount = count;
+}
+
+void imguiRenderSoftDrawTiled(unsigned int* pixels, int width, int height, int stride, int threads)
+{
+        IMGUI_PROFILE_SCOPE("imguiRenderSoftDrawTiled");
+        const imguiGfxCmd* q = imguiGetRenderQueue();
+        const unsigned nq = (unsigned)imguiGetRenderQueueSize();
+
+        if (threads <= 0)
+                threads = (int)std::thread::hardware_concurrency();
+        if (threads <= 0)
+                threads = 1;
+        if (threads > MAX_WORKERS+1)
+                threads = MAX_WORKERS+1;
+
+        const int tilesX = (width + TILE_SIZE-1) / TILE_SIZE;
+        const int tilesY = (height + TILE_SIZE-1) / TILE_SIZE;
+        const unsigned tileCount = (unsigned)(tilesX*tilesY);
+
+        if (!imguiReserve(g_cmdBounds, g_cmdBoundsCapacity, nq, 64) ||
+            !imguiReserve(g_tileClips, g_tileClipsCapacity, nq+1, 64) ||
+            !imguiReserve(g_tileStart, g_tileStartCapacity, tileCount+1, 64))
+                return;
+
+        // Clip each command's bounds against its scissor and count the
+        // entries per tile. g_cmdBounds.x0 > x1 marks a culled command.
+        unsigned clipCount = 1;
+        SoftClip clip = { 0, 0, width, height };
+        g_tileClips[0] = clip;
+        memset(g_tileStart, 0, (tileCount+1)*sizeof(unsigned));
+        for (unsigned i = 0; i < nq; ++i)
+        {
+                const imguiGfxCmd& cmd = q[i];
+                SoftClip& b = g_cmdBounds[i];
+                b.x0 = 1; b.x1 = 0;
+                if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+                {
+                        setScissor(clip, cmd, width, height);
+                        g_tileClips[clipCount++] = clip;
+                        continue;
+                }
+                const SoftClip cb = getCommandBounds(cmd);
+                b.x0 = maxi(cb.x0, clip.x0);
+                b.y0 = maxi(cb.y0, clip.y0);
+                b.x1 = mini(cb.x1, clip.x1);
+                b.y1 = mini(cb.y1, clip.y1);
+                if (b.x0 >= b.x1 || b.y0 >= b.y1)
+                {
+                        b.x0 = 1; b.x1 = 0;
+                        continue;
+                }
+                b.x0 /= TILE_SIZE; b.y0 /= TILE_SIZE;
+                b.x1 = (b.x1-1) / TILE_SIZE; b.y1 = (b.y1-1) / TILE_SIZE;
+                for (int ty = b.y0; ty <= b.y1; ++ty)
+                        for (int tx = b.x0; tx <= b.x1; ++tx)
+                                g_tileStart[ty*tilesX + tx + 1]++;
+        }
+        for (unsigned i = 0; i < tileCount; ++i)
+                g_tileStart[i+1] += g_tileStart[i];
+
+        if (!imguiReserve(g_tileEntries, g_tileEntriesCapacity, g_tileStart[tileCount], 64))
+                return;
+
+        // Fill the bins in queue order, using the start offsets as cursors.
+        clipCount = 0;
+        for (unsigned i = 0; i < nq; ++i)
+        {
+                if (q[i].type == IMGUI_GFXCMD_SCISSOR)
+                {
+                        clipCount++;
+                        continue;
+                }
+                const SoftClip& b = g_cmdBounds[i];
+                for (int ty = b.y0; ty <= b.y1 && b.x0 <= b.x1; ++ty)
+                {
+                        for (int tx = b.x0; tx <= b.x1; ++tx)
+                        {
+                                TileEntry& e = g_tileEntries[g_tileStart[ty*tilesX + tx]++];
+                                e.cmd = i;
+                                e.clip = clipCount;
+                        }
+                }
+        }
+        for (unsigned i = tileCount; i > 0; --i)
+                g_tileStart[i] = g_tileStart[i-1];
+        g_tileStart[0] = 0;
+
+        TileJob job;
+        job.target.pixels = pixels;
+        job.target.width = width;
+        job.target.height = height;
+        job.target.stride = stride;
+        job.queue = q;
+        job.tilesX = tilesX;
+        job.tileCount = (int)tileCount;
+        job.next = 0;
+        job.done = 0;
+
+        if (threads > 1)
+        {
+                startWorkers(threads-1);
+                {
+                        std::lock_guard<std::mutex> lock(g_workerMutex);
+                        g_workerJob = &job;
+                        g_workerGeneration++;
+                }
+                g_workerWake.notify_all();
+        }
+
+        rasterizeTiles(job);
+
+        if (threads > 1)
+        {
+                std::unique_lock<std::mutex> lock(g_workerMutex);
+                g_workerDone.wait(lock, [&] { return g_workersBusy == 0 && job.done.load() == job.tileCount; });
+                g_workerJob = 0;
+        }
+}
+
+bool imguiRenderSoftInit(const unsigned char* ttfData)
+{
+        if (!g_fontBitmap)
+                g_fontBitmap = (unsigned char*)imguiRealloc(0, FONT_TEXTURE_SIZE*FONT_TEXTURE_SIZE);
+        if (!g_fontBitmap)
+                return false;
+
+        stbtt_BakeFontBitmap(ttfData, 0, 15.0f, g_fontBitmap, FONT_TEXTURE_SIZE, FONT_TEXTURE_SIZE, 32,96, g_cdata);
+
+        float advances[96];
+        g_fontAscent = 0;
+        g_fontDescent = 0;
+        for (int i = 0; i < 96; ++i)
+        {
+                advances[i] = g_cdata[i].xadvance;
+                g_fontAscent = maxf(g_fontAscent, -g_cdata[i].yoff);
+                g_fontDescent = maxf(g_fontDescent, g_cdata[i].y1 - g_cdata[i].y0 + g_cdata[i].yoff);
+        }
+        imguiSetCharAdvances(advances, 32, 96);
+
+        return true;
+}
+
+bool imguiRenderSoftInit(Resource::Loader & loader, const std::string & fontpath)
+{
+        std::string ttfBuffer = loader.loadResource(fontpath);
+        if (ttfBuffer.empty())
+                return false;
+        return imguiRenderSoftInit((const unsigned char*)ttfBuffer.data());
+}
+
+void imguiRenderSoftDestroy()
+{
+        stopWorkers();
+
+        imguiFree(g_fontBitmap);
+        g_fontBitmap = 0;
+
+        imguiFree(g_cmdBounds);
+        g_cmdBounds = 0;
+        g_cmdBoundsCapacity = 0;
+        imguiFree(g_tileClips);
+        g_tileClips = 0;
+        g_tileClipsCapacity = 0;
+        imguiFree(g_tileStart);
+        g_tileStart = 0;
+        g_tileStartCapacity = 0;
+        imguiFree(g_tileEntries);
+        g_tileEntries = 0;
+        g_tileEntriesCapacity = 0;
+}
+
+bool imguiRenderSoftSetTexture(unsigned int texture, const unsigned int* pixels, int width, int height, int stride)
+{
+        SoftTexture* tex = (SoftTexture*)findTexture(texture);
+        if (!pixels || width <= 0 || height <= 0)
+        {
+                if (tex)
+                        *tex = g_textures[--g_textureCount];
+                return true;
+        }
+        if (!tex)
+        {
+                if (g_textureCount >= MAX_TEXTURES)
+                        return false;
+                tex = &g_textures[g_textureCount++];
+        }
+        tex->handle = texture;
+        tex->pixels = pixels;
+        tex->width = width;
+        tex->height = height;
+        tex->stride = stride;
+        return true;
+}
+
+void imguiRenderSoftClear(unsigned int* pixels, int width, int height, int stride, unsigned int color)
+{
+        for (int y = 0; y < height; ++y)
+        {
+                unsigned int* row = pixels + y*stride;
+                for (int x = 0; x < width; ++x)
+                        row[x] = color;
+        }
+}
+
+bool imguiRenderSoftSaveTGA(const char* path, const unsigned int* pixels, int width, int height, int stride)
+{
+        FILE* fp = fopen(path, "wb");
+        if (!fp)
+                return false;
+
+        // Uncompressed true-color, 8 alpha bits, bottom-left origin.
+        unsigned char header[18];
+        memset(header, 0, sizeof(header));
+        header[2] = 2;
+        header[12] = (unsigned char)(width & 0xff);
+        header[13] = (unsigned char)((width >> 8) & 0xff);
+        header[14] = (unsigned char)(height & 0xff);
+        header[15] = (unsigned char)((height >> 8) & 0xff);
+        header[16] = 32;
+        header[17] = 8;
+        fwrite(header, 1, sizeof(header), fp);
+
+        unsigned char* row = (unsigned char*)imguiRealloc(0, width*4);
+        if (!row)
+        {
+                fclose(fp);
+                return false;
+        }
+        for (int y = 0; y < height; ++y)
+        {
+                const unsigned int* src = pixels + y*stride;
+                for (int x = 0; x < width; ++x)
+                {
+                        const unsigned int c = src[x];
+                        row[x*4+0] = (unsigned char)((c >> 16) & 0xff);
+                        row[x*4+1] = (unsigned char)((c >> 8) & 0xff);
+                        row[x*4+2] = (unsigned char)(c & 0xff);
+                        row[x*4+3] = (unsigned char)((c >> 24) & 0xff);
+                }
+                fwrite(row, 1, width*4, fp);
+        }
+        imguiFree(row);
+
+        const bool ok = ferror(fp) == 0;
+        fclose(fp);
+        return ok;
+}
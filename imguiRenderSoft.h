@@ -0,0 +1,44 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_RENDER_SOFT_H
+#define IMGUI_RENDER_SOFT_H
+
+#include <string>
+#include <yip-imports/resource_loader.h>
+
+// CPU renderer for the imgui render queue. Pixels are RGBA8 packed like
+// imguiRGBA(), rows are stored bottom-up to match the queue coordinates.
+
+bool imguiRenderSoftInit(Resource::Loader & loader, const std::string & fontpath);
+bool imguiRenderSoftInit(const unsigned char* ttfData);
+void imguiRenderSoftDestroy();
+void imguiRenderSoftClear(unsigned int* pixels, int width, int height, int stride, unsigned int color);
+void imguiRenderSoftDraw(unsigned int* pixels, int width, int height, int stride);
+// Bins the queue into 64x64 tiles and rasterizes them on 'threads' threads
+// (0 uses all hardware threads). Output matches imguiRenderSoftDraw().
+void imguiRenderSoftDrawTiled(unsigned int* pixels, int width, int height, int stride, int threads);
+// Pixels for image commands using 'texture', RGBA8 like the target with the
+// first row at v = 0. They are referenced until replaced or removed with null
+// pixels, and sampled nearest. Up to 64 textures.
+bool imguiRenderSoftSetTexture(unsigned int texture, const unsigned int* pixels, int width, int height, int stride);
+bool imguiRenderSoftSaveTGA(const char* path, const unsigned int* pixels, int width, int height, int stride);
+
+#endif // IMGUI_RENDER_SOFT_H
@@ -0,0 +1,929 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#include <stddef.h>
+#include <string.h>
+#include <chrono>
+
+#include "imguiRenderVulkan.h"
+
+#include "imgui.h"
+
+#include "imguiTessellate.h"
+#include "imguiProfiler.h"
+
+// SPIR-V 1.0 of
+//
+//   #version 450
+//   layout(push_constant) uniform Transform { vec2 scale; vec2 translate; } transform;
+//   layout(location = 0) in vec2 VertexPosition;
+//   layout(location = 1) in vec2 VertexTexCoord;
+//   layout(location = 2) in vec4 VertexColor;
+//   layout(location = 0) out vec2 texCoord;
+//   layout(location = 1) out vec4 vertexColor;
+//   void main()
+//   {
+//       texCoord = VertexTexCoord;
+//       vertexColor = VertexColor;
+//       gl_Position = vec4(VertexPosition * transform.scale + transform.translate, 0.0, 1.0);
+//   }
+static const uint32_t g_vertexShader[] =
+{
+        0x07230203, 0x00010000, 0x00000000, 0x00000027, 0x00000000, 0x00020011,
+        0x00000001, 0x0003000e, 0x00000000, 0x00000001, 0x000b000f, 0x00000000,
+        0x00000018, 0x6e69616d, 0x00000000, 0x0000000c, 0x0000000e, 0x0000000f,
+        0x00000011, 0x00000013, 0x00000015, 0x00030047, 0x00000009, 0x00000002,
+        0x00050048, 0x00000009, 0x00000000, 0x00000023, 0x00000000, 0x00050048,
+        0x00000009, 0x00000001, 0x00000023, 0x00000008, 0x00040047, 0x0000000c,
+        0x0000001e, 0x00000000, 0x00040047, 0x0000000e, 0x0000001e, 0x00000001,
+        0x00040047, 0x0000000f, 0x0000001e, 0x00000002, 0x00040047, 0x00000011,
+        0x0000001e, 0x00000000, 0x00040047, 0x00000013, 0x0000001e, 0x00000001,
+        0x00040047, 0x00000015, 0x0000000b, 0x00000000, 0x00020013, 0x00000001,
+        0x00030021, 0x00000002, 0x00000001, 0x00030016, 0x00000003, 0x00000020,
+        0x00040017, 0x00000004, 0x00000003, 0x00000002, 0x00040017, 0x00000005,
+        0x00000003, 0x00000004, 0x00040015, 0x00000006, 0x00000020, 0x00000001,
+        0x0004002b, 0x00000006, 0x00000007, 0x00000000, 0x0004002b, 0x00000006,
+        0x00000008, 0x00000001, 0x0004001e, 0x00000009, 0x00000004, 0x00000004,
+        0x0004002b, 0x00000003, 0x0000000a, 0x00000000, 0x0004002b, 0x00000003,
+        0x0000000b, 0x3f800000, 0x00040020, 0x0000000d, 0x00000001, 0x00000004,
+        0x0004003b, 0x0000000d, 0x0000000c, 0x00000001, 0x0004003b, 0x0000000d,
+        0x0000000e, 0x00000001, 0x00040020, 0x00000010, 0x00000001, 0x00000005,
+        0x0004003b, 0x00000010, 0x0000000f, 0x00000001, 0x00040020, 0x00000012,
+        0x00000003, 0x00000004, 0x0004003b, 0x00000012, 0x00000011, 0x00000003,
+        0x00040020, 0x00000014, 0x00000003, 0x00000005, 0x0004003b, 0x00000014,
+        0x00000013, 0x00000003, 0x0004003b, 0x00000014, 0x00000015, 0x00000003,
+        0x00040020, 0x00000017, 0x00000009, 0x00000009, 0x0004003b, 0x00000017,
+        0x00000016, 0x00000009, 0x00040020, 0x0000001d, 0x00000009, 0x00000004,
+        0x00050036, 0x00000001, 0x00000018, 0x00000000, 0x00000002, 0x000200f8,
+        0x00000019, 0x0004003d, 0x00000004, 0x0000001a, 0x0000000e, 0x0003003e,
+        0x00000011, 0x0000001a, 0x0004003d, 0x00000005, 0x0000001b, 0x0000000f,
+        0x0003003e, 0x00000013, 0x0000001b, 0x0004003d, 0x00000004, 0x0000001c,
+        0x0000000c, 0x00050041, 0x0000001d, 0x0000001e, 0x00000016, 0x00000007,
+        0x0004003d, 0x00000004, 0x0000001f, 0x0000001e, 0x00050041, 0x0000001d,
+        0x00000020, 0x00000016, 0x00000008, 0x0004003d, 0x00000004, 0x00000021,
+        0x00000020, 0x00050085, 0x00000004, 0x00000022, 0x0000001c, 0x0000001f,
+        0x00050081, 0x00000004, 0x00000023, 0x00000022, 0x00000021, 0x00050051,
+        0x00000003, 0x00000024, 0x00000023, 0x00000000, 0x00050051, 0x00000003,
+        0x00000025, 0x00000023, 0x00000001, 0x00070050, 0x00000005, 0x00000026,
+        0x00000024, 0x00000025, 0x0000000a, 0x0000000b, 0x0003003e, 0x00000015,
+        0x00000026, 0x000100fd, 0x00010038,
+};
+
+// SPIR-V 1.0 of
+//
+//   #version 450
+//   layout(push_constant) uniform Mode { layout(offset = 16) float textured; float image; } mode;
+//   layout(set = 0, binding = 0) uniform sampler2D Texture;
+//   layout(location = 0) in vec2 texCoord;
+//   layout(location = 1) in vec4 vertexColor;
+//   layout(location = 0) out vec4 fragColor;
+//   void main()
+//   {
+//       vec4 texel = texture(Texture, texCoord);
+//       texel = mode.textured > 0.5 ? texel : vec4(1.0);
+//       fragColor = mode.image > 0.5 ? vertexColor * texel
+//                                    : vec4(vertexColor.rgb, vertexColor.a * texel.r);
+//   }
+static const uint32_t g_fragmentShader[] =
+{
+        0x07230203, 0x00010000, 0x00000000, 0x00000031, 0x00000000, 0x00020011,
+        0x00000001, 0x0003000e, 0x00000000, 0x00000001, 0x0008000f, 0x00000004,
+        0x0000001b, 0x6e69616d, 0x00000000, 0x00000011, 0x00000013, 0x00000015,
+        0x00030010, 0x0000001b, 0x00000007, 0x00030047, 0x00000009, 0x00000002,
+        0x00050048, 0x00000009, 0x00000000, 0x00000023, 0x00000010, 0x00050048,
+        0x00000009, 0x00000001, 0x00000023, 0x00000014, 0x00040047, 0x00000011,
+        0x0000001e, 0x00000000, 0x00040047, 0x00000013, 0x0000001e, 0x00000001,
+        0x00040047, 0x00000015, 0x0000001e, 0x00000000, 0x00040047, 0x00000017,
+        0x00000022, 0x00000000, 0x00040047, 0x00000017, 0x00000021, 0x00000000,
+        0x00020013, 0x00000001, 0x00030021, 0x00000002, 0x00000001, 0x00030016,
+        0x00000003, 0x00000020, 0x00040017, 0x00000004, 0x00000003, 0x00000002,
+        0x00040017, 0x00000005, 0x00000003, 0x00000004, 0x00040015, 0x00000006,
+        0x00000020, 0x00000001, 0x0004002b, 0x00000006, 0x00000007, 0x00000000,
+        0x0004002b, 0x00000006, 0x00000008, 0x00000001, 0x0004001e, 0x00000009,
+        0x00000003, 0x00000003, 0x00090019, 0x0000000a, 0x00000003, 0x00000001,
+        0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000, 0x0003001b,
+        0x0000000b, 0x0000000a, 0x00020014, 0x0000000c, 0x00040017, 0x0000000d,
+        0x0000000c, 0x00000004, 0x0004002b, 0x00000003, 0x0000000e, 0x3f000000,
+        0x0004002b, 0x00000003, 0x0000000f, 0x3f800000, 0x0007002c, 0x00000005,
+        0x00000010, 0x0000000f, 0x0000000f, 0x0000000f, 0x0000000f, 0x00040020,
+        0x00000012, 0x00000001, 0x00000004, 0x0004003b, 0x00000012, 0x00000011,
+        0x00000001, 0x00040020, 0x00000014, 0x00000001, 0x00000005, 0x0004003b,
+        0x00000014, 0x00000013, 0x00000001, 0x00040020, 0x00000016, 0x00000003,
+        0x00000005, 0x0004003b, 0x00000016, 0x00000015, 0x00000003, 0x00040020,
+        0x00000018, 0x00000000, 0x0000000b, 0x0004003b, 0x00000018, 0x00000017,
+        0x00000000, 0x00040020, 0x0000001a, 0x00000009, 0x00000009, 0x0004003b,
+        0x0000001a, 0x00000019, 0x00000009, 0x00040020, 0x00000021, 0x00000009,
+        0x00000003, 0x00050036, 0x00000001, 0x0000001b, 0x00000000, 0x00000002,
+        0x000200f8, 0x0000001c, 0x0004003d, 0x00000004, 0x0000001d, 0x00000011,
+        0x0004003d, 0x00000005, 0x0000001e, 0x00000013, 0x0004003d, 0x0000000b,
+        0x0000001f, 0x00000017, 0x00050057, 0x00000005, 0x00000020, 0x0000001f,
+        0x0000001d, 0x00050041, 0x00000021, 0x00000022, 0x00000019, 0x00000007,
+        0x0004003d, 0x00000003, 0x00000023, 0x00000022, 0x00050041, 0x00000021,
+        0x00000024, 0x00000019, 0x00000008, 0x0004003d, 0x00000003, 0x00000025,
+        0x00000024, 0x000500ba, 0x0000000c, 0x00000026, 0x00000023, 0x0000000e,
+        0x00070050, 0x0000000d, 0x00000027, 0x00000026, 0x00000026, 0x00000026,
+        0x00000026, 0x000600a9, 0x00000005, 0x00000028, 0x00000027, 0x00000020,
+        0x00000010, 0x00050051, 0x00000003, 0x00000029, 0x0000001e, 0x00000003,
+        0x00050051, 0x00000003, 0x0000002a, 0x00000028, 0x00000000, 0x00050085,
+        0x00000003, 0x0000002b, 0x00000029, 0x0000002a, 0x00060052, 0x00000005,
+        0x0000002c, 0x0000002b, 0x0000001e, 0x00000003, 0x00050085, 0x00000005,
+        0x0000002d, 0x0000001e, 0x00000028, 0x000500ba, 0x0000000c, 0x0000002e,
+        0x00000025, 0x0000000e, 0x00070050, 0x0000000d, 0x0000002f, 0x0000002e,
+        0x0000002e, 0x0000002e, 0x0000002e, 0x000600a9, 0x00000005, 0x00000030,
+        0x0000002f, 0x0000002d, 0x0000002c, 0x0003003e, 0x00000015, 0x00000030,
+        0x000100fd, 0x00010038,
+};
+
+struct VertexTransform
+{
+        float scale[2];
+        float translate[2];
+};
+
+// Fragment push constants follow the vertex ones. White draws take neither
+// the texture nor a descriptor change, the font holds coverage in red and
+// images are sampled as RGBA.
+struct FragmentMode
+{
+        float textured;
+        float image;
+};
+
+static const FragmentMode MODE_WHITE = { 0.0f, 0.0f };
+static const FragmentMode MODE_FONT = { 1.0f, 0.0f };
+static const FragmentMode MODE_IMAGE = { 1.0f, 1.0f };
+
+// Host visible buffer, mapped for its whole life.
+struct VulkanBuffer
+{
+        VkBuffer buffer;
+        VkDeviceMemory memory;
+        VkDeviceSize size;
+        void* mapped;
+};
+
+// Image views registered for image commands, each with its descriptor set.
+struct VulkanTexture
+{
+        unsigned int handle;
+        VkDescriptorSet set;
+};
+
+// Set of a replaced or removed texture, freed once the draw that may still
+// use it has finished.
+struct RetiredSet
+{
+        VkDescriptorSet set;
+        unsigned long long draw;
+};
+
+static const uint32_t MAX_FRAMES = 8;
+static const int MAX_TEXTURES = 64;
+static const int MAX_RETIRED = 64;
+static const int FONT_SIZE = 512;
+
+static imguiVulkanInitInfo g_info;
+static VkPhysicalDeviceMemoryProperties g_memoryProperties;
+static VkSampler g_sampler = VK_NULL_HANDLE;
+static VkDescriptorSetLayout g_setLayout = VK_NULL_HANDLE;
+static VkDescriptorPool g_descriptorPool = VK_NULL_HANDLE;
+static VkPipelineLayout g_pipelineLayout = VK_NULL_HANDLE;
+static VkPipeline g_pipeline = VK_NULL_HANDLE;
+
+static VkImage g_fontImage = VK_NULL_HANDLE;
+static VkDeviceMemory g_fontMemory = VK_NULL_HANDLE;
+static VkImageView g_fontView = VK_NULL_HANDLE;
+static VkDescriptorSet g_fontSet = VK_NULL_HANDLE;
+
+static VulkanBuffer g_frames[MAX_FRAMES];
+static uint32_t g_frameIndex = 0;
+
+static VulkanTexture g_textures[MAX_TEXTURES];
+static int g_textureCount = 0;
+static RetiredSet g_retired[MAX_RETIRED];
+static int g_retiredCount = 0;
+static unsigned long long g_drawCount = 0;
+
+static imguiDrawList g_drawList;
+
+static bool findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags flags, uint32_t& type)
+{
+        for (uint32_t i = 0; i < g_memoryProperties.memoryTypeCount; ++i)
+        {
+                if ((typeBits & (1u << i)) && (g_memoryProperties.memoryTypes[i].propertyFlags & flags) == flags)
+                {
+                        type = i;
+                        return true;
+                }
+        }
+        return false;
+}
+
+static void destroyBuffer(VulkanBuffer& buf)
+{
+        if (buf.buffer)
+                vkDestroyBuffer(g_info.device, buf.buffer, g_info.allocator);
+        if (buf.memory)
+                vkFreeMemory(g_info.device, buf.memory, g_info.allocator);
+        buf.buffer = VK_NULL_HANDLE;
+        buf.memory = VK_NULL_HANDLE;
+        buf.size = 0;
+        buf.mapped = 0;
+}
+
+static bool createBuffer(VulkanBuffer& buf, VkDeviceSize size, VkBufferUsageFlags usage)
+{
+        VkBufferCreateInfo bufferInfo;
+        memset(&bufferInfo, 0, sizeof(bufferInfo));
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.size = size;
+        bufferInfo.usage = usage;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vkCreateBuffer(g_info.device, &bufferInfo, g_info.allocator, &buf.buffer) != VK_SUCCESS)
+                return false;
+
+        VkMemoryRequirements req;
+        vkGetBufferMemoryRequirements(g_info.device, buf.buffer, &req);
+        VkMemoryAllocateInfo allocInfo;
+        memset(&allocInfo, 0, sizeof(allocInfo));
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = req.size;
+        if (!findMemoryType(req.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                            allocInfo.memoryTypeIndex) ||
+            vkAllocateMemory(g_info.device, &allocInfo, g_info.allocator, &buf.memory) != VK_SUCCESS ||
+            vkBindBufferMemory(g_info.device, buf.buffer, buf.memory, 0) != VK_SUCCESS ||
+            vkMapMemory(g_info.device, buf.memory, 0, VK_WHOLE_SIZE, 0, &buf.mapped) != VK_SUCCESS)
+        {
+                destroyBuffer(buf);
+                return false;
+        }
+        buf.size = size;
+        return true;
+}
+
+// Grows to a power of two so a slot settles after a few frames.
+static bool reserveBuffer(VulkanBuffer& buf, VkDeviceSize size)
+{
+        if (size <= buf.size)
+                return true;
+        VkDeviceSize n = buf.size ? buf.size : 64*1024;
+        while (n < size)
+                n *= 2;
+        destroyBuffer(buf);
+        return createBuffer(buf, n, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
+}
+
+static VkDescriptorSet allocateSet(VkImageView view, VkSampler sampler)
+{
+        VkDescriptorSetAllocateInfo allocInfo;
+        memset(&allocInfo, 0, sizeof(allocInfo));
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = g_descriptorPool;
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &g_setLayout;
+        VkDescriptorSet set = VK_NULL_HANDLE;
+        if (vkAllocateDescriptorSets(g_info.device, &allocInfo, &set) != VK_SUCCESS)
+                return VK_NULL_HANDLE;
+
+        VkDescriptorImageInfo imageInfo;
+        imageInfo.sampler = sampler ? sampler : g_sampler;
+        imageInfo.imageView = view;
+        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+        VkWriteDescriptorSet write;
+        memset(&write, 0, sizeof(write));
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = set;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        write.pImageInfo = &imageInfo;
+        vkUpdateDescriptorSets(g_info.device, 1, &write, 0, 0);
+        return set;
+}
+
+static VkShaderModule createShader(const uint32_t* code, size_t size)
+{
+        VkShaderModuleCreateInfo moduleInfo;
+        memset(&moduleInfo, 0, sizeof(moduleInfo));
+        moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+        moduleInfo.codeSize = size;
+        moduleInfo.pCode = code;
+        VkShaderModule module = VK_NULL_HANDLE;
+        vkCreateShaderModule(g_info.device, &moduleInfo, g_info.allocator, &module);
+        return module;
+}
+
+static bool createPipeline()
+{
+        VkShaderModule vs = createShader(g_vertexShader, sizeof(g_vertexShader));
+        VkShaderModule fs = createShader(g_fragmentShader, sizeof(g_fragmentShader));
+        if (!vs || !fs)
+        {
+                if (vs)
+                        vkDestroyShaderModule(g_info.device, vs, g_info.allocator);
+                if (fs)
+                        vkDestroyShaderModule(g_info.device, fs, g_info.allocator);
+                return false;
+        }
+
+        VkPipelineShaderStageCreateInfo stages[2];
+        memset(stages, 0, sizeof(stages));
+        stages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+        stages[0].module = vs;
+        stages[0].pName = "main";
+        stages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+        stages[1].module = fs;
+        stages[1].pName = "main";
+
+        VkVertexInputBindingDescription binding;
+        binding.binding = 0;
+        binding.stride = sizeof(imguiVertex);
+        binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        VkVertexInputAttributeDescription attributes[3];
+        attributes[0].location = 0;
+        attributes[0].binding = 0;
+        attributes[0].format = VK_FORMAT_R32G32_SFLOAT;
+        attributes[0].offset = offsetof(imguiVertex, x);
+        attributes[1].location = 1;
+        attributes[1].binding = 0;
+        attributes[1].format = VK_FORMAT_R32G32_SFLOAT;
+        attributes[1].offset = offsetof(imguiVertex, u);
+        attributes[2].location = 2;
+        attributes[2].binding = 0;
+        attributes[2].format = VK_FORMAT_R8G8B8A8_UNORM;
+        attributes[2].offset = offsetof(imguiVertex, col);
+
+        VkPipelineVertexInputStateCreateInfo vertexInput;
+        memset(&vertexInput, 0, sizeof(vertexInput));
+        vertexInput.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+        vertexInput.vertexBindingDescriptionCount = 1;
+        vertexInput.pVertexBindingDescriptions = &binding;
+        vertexInput.vertexAttributeDescriptionCount = 3;
+        vertexInput.pVertexAttributeDescriptions = attributes;
+
+        VkPipelineInputAssemblyStateCreateInfo inputAssembly;
+        memset(&inputAssembly, 0, sizeof(inputAssembly));
+        inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+        inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+        VkPipelineViewportStateCreateInfo viewport;
+        memset(&viewport, 0, sizeof(viewport));
+        viewport.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+        viewport.viewportCount = 1;
+        viewport.scissorCount = 1;
+
+        VkPipelineRasterizationStateCreateInfo raster;
+        memset(&raster, 0, sizeof(raster));
+        raster.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+        raster.polygonMode = VK_POLYGON_MODE_FILL;
+        raster.cullMode = VK_CULL_MODE_NONE;
+        raster.frontFace = VK_FRONT_FACE_COUNTER_CLOCKWISE;
+        raster.lineWidth = 1.0f;
+
+        VkPipelineMultisampleStateCreateInfo multisample;
+        memset(&multisample, 0, sizeof(multisample));
+        multisample.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+        multisample.rasterizationSamples = g_info.samples ? g_info.samples : VK_SAMPLE_COUNT_1_BIT;
+
+        VkPipelineDepthStencilStateCreateInfo depthStencil;
+        memset(&depthStencil, 0, sizeof(depthStencil));
+        depthStencil.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+
+        // Same blending as imguiRenderGL3, glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA).
+        VkPipelineColorBlendAttachmentState blendAttachment;
+        memset(&blendAttachment, 0, sizeof(blendAttachment));
+        blendAttachment.blendEnable = VK_TRUE;
+        blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        blendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                         VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        VkPipelineColorBlendStateCreateInfo blend;
+        memset(&blend, 0, sizeof(blend));
+        blend.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+        blend.attachmentCount = 1;
+        blend.pAttachments = &blendAttachment;
+
+        const VkDynamicState dynamicStates[2] = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
+        VkPipelineDynamicStateCreateInfo dynamic;
+        memset(&dynamic, 0, sizeof(dynamic));
+        dynamic.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+        dynamic.dynamicStateCount = 2;
+        dynamic.pDynamicStates = dynamicStates;
+
+        VkGraphicsPipelineCreateInfo pipelineInfo;
+        memset(&pipelineInfo, 0, sizeof(pipelineInfo));
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.stageCount = 2;
+        pipelineInfo.pStages = stages;
+        pipelineInfo.pVertexInputState = &vertexInput;
+        pipelineInfo.pInputAssemblyState = &inputAssembly;
+        pipelineInfo.pViewportState = &viewport;
+        pipelineInfo.pRasterizationState = &raster;
+        pipelineInfo.pMultisampleState = &multisample;
+        pipelineInfo.pDepthStencilState = &depthStencil;
+        pipelineInfo.pColorBlendState = &blend;
+        pipelineInfo.pDynamicState = &dynamic;
+        pipelineInfo.layout = g_pipelineLayout;
+        pipelineInfo.renderPass = g_info.renderPass;
+        pipelineInfo.subpass = g_info.subpass;
+
+        const VkResult res = vkCreateGraphicsPipelines(g_info.device, g_info.pipelineCache, 1, &pipelineInfo,
+                                                       g_info.allocator, &g_pipeline);
+        vkDestroyShaderModule(g_info.device, vs, g_info.allocator);
+        vkDestroyShaderModule(g_info.device, fs, g_info.allocator);
+        return res == VK_SUCCESS;
+}
+
+static bool createLayouts()
+{
+        VkSamplerCreateInfo samplerInfo;
+        memset(&samplerInfo, 0, sizeof(samplerInfo));
+        samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+        samplerInfo.magFilter = VK_FILTER_LINEAR;
+        samplerInfo.minFilter = VK_FILTER_LINEAR;
+        samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+        samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+        if (vkCreateSampler(g_info.device, &samplerInfo, g_info.allocator, &g_sampler) != VK_SUCCESS)
+                return false;
+
+        VkDescriptorSetLayoutBinding binding;
+        memset(&binding, 0, sizeof(binding));
+        binding.binding = 0;
+        binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        binding.descriptorCount = 1;
+        binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        VkDescriptorSetLayoutCreateInfo setInfo;
+        memset(&setInfo, 0, sizeof(setInfo));
+        setInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+        setInfo.bindingCount = 1;
+        setInfo.pBindings = &binding;
+        if (vkCreateDescriptorSetLayout(g_info.device, &setInfo, g_info.allocator, &g_setLayout) != VK_SUCCESS)
+                return false;
+
+        // One set for the font, one per registered texture and the retired
+        // ones not freed yet.
+        VkDescriptorPoolSize poolSize;
+        poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        poolSize.descriptorCount = MAX_TEXTURES + MAX_RETIRED + 1;
+        VkDescriptorPoolCreateInfo poolInfo;
+        memset(&poolInfo, 0, sizeof(poolInfo));
+        poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+        poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+        poolInfo.maxSets = MAX_TEXTURES + MAX_RETIRED + 1;
+        poolInfo.poolSizeCount = 1;
+        poolInfo.pPoolSizes = &poolSize;
+        if (vkCreateDescriptorPool(g_info.device, &poolInfo, g_info.allocator, &g_descriptorPool) != VK_SUCCESS)
+                return false;
+
+        VkPushConstantRange ranges[2];
+        ranges[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        ranges[0].offset = 0;
+        ranges[0].size = sizeof(VertexTransform);
+        ranges[1].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        ranges[1].offset = sizeof(VertexTransform);
+        ranges[1].size = sizeof(FragmentMode);
+        VkPipelineLayoutCreateInfo layoutInfo;
+        memset(&layoutInfo, 0, sizeof(layoutInfo));
+        layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+        layoutInfo.setLayoutCount = 1;
+        layoutInfo.pSetLayouts = &g_setLayout;
+        layoutInfo.pushConstantRangeCount = 2;
+        layoutInfo.pPushConstantRanges = ranges;
+        return vkCreatePipelineLayout(g_info.device, &layoutInfo, g_info.allocator, &g_pipelineLayout) == VK_SUCCESS;
+}
+
+static void imageBarrier(VkCommandBuffer cmd, VkImageLayout from, VkImageLayout to,
+                         VkAccessFlags srcAccess, VkAccessFlags dstAccess,
+                         VkPipelineStageFlags srcStage, VkPipelineStageFlags dstStage)
+{
+        VkImageMemoryBarrier barrier;
+        memset(&barrier, 0, sizeof(barrier));
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = srcAccess;
+        barrier.dstAccessMask = dstAccess;
+        barrier.oldLayout = from;
+        barrier.newLayout = to;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = g_fontImage;
+        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        barrier.subresourceRange.levelCount = 1;
+        barrier.subresourceRange.layerCount = 1;
+        vkCmdPipelineBarrier(cmd, srcStage, dstStage, 0, 0, 0, 0, 0, 1, &barrier);
+}
+
+// Copies the atlas through a staging buffer and waits for the queue, once.
+static bool uploadFont(const unsigned char* bitmap)
+{
+        VulkanBuffer staging;
+        memset(&staging, 0, sizeof(staging));
+        if (!createBuffer(staging, FONT_SIZE*FONT_SIZE, VK_BUFFER_USAGE_TRANSFER_SRC_BIT))
+                return false;
+        memcpy(staging.mapped, bitmap, FONT_SIZE*FONT_SIZE);
+
+        VkCommandPoolCreateInfo poolInfo;
+        memset(&poolInfo, 0, sizeof(poolInfo));
+        poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+        poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+        poolInfo.queueFamilyIndex = g_info.queueFamilyIndex;
+        VkCommandPool pool = VK_NULL_HANDLE;
+        if (vkCreateCommandPool(g_info.device, &poolInfo, g_info.allocator, &pool) != VK_SUCCESS)
+        {
+                destroyBuffer(staging);
+                return false;
+        }
+
+        VkCommandBufferAllocateInfo allocInfo;
+        memset(&allocInfo, 0, sizeof(allocInfo));
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.commandPool = pool;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        VkCommandBuffer cmd = VK_NULL_HANDLE;
+        VkCommandBufferBeginInfo beginInfo;
+        memset(&beginInfo, 0, sizeof(beginInfo));
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+        bool ok = vkAllocateCommandBuffers(g_info.device, &allocInfo, &cmd) == VK_SUCCESS &&
+                  vkBeginCommandBuffer(cmd, &beginInfo) == VK_SUCCESS;
+        if (ok)
+        {
+                imageBarrier(cmd, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                             0, VK_ACCESS_TRANSFER_WRITE_BIT,
+                             VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT);
+                VkBufferImageCopy region;
+                memset(&region, 0, sizeof(region));
+                region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+                region.imageSubresource.layerCount = 1;
+                region.imageExtent.width = FONT_SIZE;
+                region.imageExtent.height = FONT_SIZE;
+                region.imageExtent.depth = 1;
+                vkCmdCopyBufferToImage(cmd, staging.buffer, g_fontImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+                imageBarrier(cmd, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                             VK_ACCESS_TRANSFER_WRITE_BIT, VK_ACCESS_SHADER_READ_BIT,
+                             VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+
+                VkSubmitInfo submit;
+                memset(&submit, 0, sizeof(submit));
+                submit.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+                submit.commandBufferCount = 1;
+                submit.pCommandBuffers = &cmd;
+                ok = vkEndCommandBuffer(cmd) == VK_SUCCESS &&
+                     vkQueueSubmit(g_info.queue, 1, &submit, VK_NULL_HANDLE) == VK_SUCCESS &&
+                     vkQueueWaitIdle(g_info.queue) == VK_SUCCESS;
+        }
+
+        vkDestroyCommandPool(g_info.device, pool, g_info.allocator);
+        destroyBuffer(staging);
+        return ok;
+}
+
+static bool createFont(const unsigned char* bitmap)
+{
+        VkImageCreateInfo imageInfo;
+        memset(&imageInfo, 0, sizeof(imageInfo));
+        imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+        imageInfo.imageType = VK_IMAGE_TYPE_2D;
+        imageInfo.format = VK_FORMAT_R8_UNORM;
+        imageInfo.extent.width = FONT_SIZE;
+        imageInfo.extent.height = FONT_SIZE;
+        imageInfo.extent.depth = 1;
+        imageInfo.mipLevels = 1;
+        imageInfo.arrayLayers = 1;
+        imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+        imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+        imageInfo.usage = VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        if (vkCreateImage(g_info.device, &imageInfo, g_info.allocator, &g_fontImage) != VK_SUCCESS)
+                return false;
+
+        VkMemoryRequirements req;
+        vkGetImageMemoryRequirements(g_info.device, g_fontImage, &req);
+        VkMemoryAllocateInfo allocInfo;
+        memset(&allocInfo, 0, sizeof(allocInfo));
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = req.size;
+        if (!findMemoryType(req.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, allocInfo.memoryTypeIndex) &&
+            !findMemoryType(req.memoryTypeBits, 0, allocInfo.memoryTypeIndex))
+                return false;
+        if (vkAllocateMemory(g_info.device, &allocInfo, g_info.allocator, &g_fontMemory) != VK_SUCCESS ||
+            vkBindImageMemory(g_info.device, g_fontImage, g_fontMemory, 0) != VK_SUCCESS)
+                return false;
+
+        VkImageViewCreateInfo viewInfo;
+        memset(&viewInfo, 0, sizeof(viewInfo));
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = g_fontImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = VK_FORMAT_R8_UNORM;
+        viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        viewInfo.subresourceRange.levelCount = 1;
+        viewInfo.subresourceRange.layerCount = 1;
+        if (vkCreateImageView(g_info.device, &viewInfo, g_info.allocator, &g_fontView) != VK_SUCCESS)
+                return false;
+
+        if (!uploadFont(bitmap))
+                return false;
+        g_fontSet = allocateSet(g_fontView, VK_NULL_HANDLE);
+        return g_fontSet != VK_NULL_HANDLE;
+}
+
+bool imguiRenderVulkanInit(const imguiVulkanInitInfo& info, Resource::Loader & loader, const std::string & fontpath)
+{
+        std::string ttfBuffer = loader.loadResource(fontpath);
+        if (ttfBuffer.empty())
+                return false;
+        return imguiRenderVulkanInit(info, (const unsigned char*)ttfBuffer.data());
+}
+
+bool imguiRenderVulkanInit(const imguiVulkanInitInfo& info, const unsigned char* ttfData)
+{
+        if (!info.device || !info.renderPass || info.framesInFlight > MAX_FRAMES)
+                return false;
+        imguiRenderVulkanDestroy();
+        g_info = info;
+        if (!g_info.framesInFlight)
+                g_info.framesInFlight = 1;
+        vkGetPhysicalDeviceMemoryProperties(g_info.physicalDevice, &g_memoryProperties);
+
+        unsigned char* bmap = (unsigned char*)imguiRealloc(0, FONT_SIZE*FONT_SIZE);
+        if (!bmap)
+                return false;
+
+        const bool ok = imguiTessInit(ttfData, bmap, FONT_SIZE, FONT_SIZE) &&
+                        createLayouts() && createPipeline() && createFont(bmap);
+        imguiFree(bmap);
+        if (!ok)
+        {
+                imguiRenderVulkanDestroy();
+                return false;
+        }
+        return true;
+}
+
+void imguiRenderVulkanDestroy()
+{
+        if (!g_info.device)
+                return;
+        const VkDevice device = g_info.device;
+        const VkAllocationCallbacks* allocator = g_info.allocator;
+
+        for (uint32_t i = 0; i < MAX_FRAMES; ++i)
+                destroyBuffer(g_frames[i]);
+        g_frameIndex = 0;
+
+        // Sets go with their pool.
+        g_textureCount = 0;
+        g_retiredCount = 0;
+        g_drawCount = 0;
+        g_fontSet = VK_NULL_HANDLE;
+
+        if (g_fontView)
+                vkDestroyImageView(device, g_fontView, allocator);
+        if (g_fontImage)
+                vkDestroyImage(device, g_fontImage, allocator);
+        if (g_fontMemory)
+                vkFreeMemory(device, g_fontMemory, allocator);
+        if (g_pipeline)
+                vkDestroyPipeline(device, g_pipeline, allocator);
+        if (g_pipelineLayout)
+                vkDestroyPipelineLayout(device, g_pipelineLayout, allocator);
+        if (g_descriptorPool)
+                vkDestroyDescriptorPool(device, g_descriptorPool, allocator);
+        if (g_setLayout)
+                vkDestroyDescriptorSetLayout(device, g_setLayout, allocator);
+        if (g_sampler)
+                vkDestroySampler(device, g_sampler, allocator);
+        g_fontView = VK_NULL_HANDLE;
+        g_fontImage = VK_NULL_HANDLE;
+        g_fontMemory = VK_NULL_HANDLE;
+        g_pipeline = VK_NULL_HANDLE;
+        g_pipelineLayout = VK_NULL_HANDLE;
+        g_descriptorPool = VK_NULL_HANDLE;
+        g_setLayout = VK_NULL_HANDLE;
+        g_sampler = VK_NULL_HANDLE;
+
+        imguiTessFreeDrawList(&g_drawList);
+        memset(&g_info, 0, sizeof(g_info));
+}
+
+static VulkanTexture* findTexture(unsigned int handle)
+{
+        for (int i = 0; i < g_textureCount; ++i)
+                if (g_textures[i].handle == handle)
+                        return &g_textures[i];
+        return 0;
+}
+
+// Frees the retired sets that no pending draw can use: the draw that
+// takes a buffer slot framesInFlight draws later waits for the earlier one.
+static void freeRetiredSets()
+{
+        int n = 0;
+        for (int i = 0; i < g_retiredCount; ++i)
+        {
+                if (g_retired[i].draw + g_info.framesInFlight <= g_drawCount)
+                        vkFreeDescriptorSets(g_info.device, g_descriptorPool, 1, &g_retired[i].set);
+                else
+                        g_retired[n++] = g_retired[i];
+        }
+        g_retiredCount = n;
+}
+
+bool imguiRenderVulkanSetTexture(unsigned int texture, VkImageView view, VkSampler sampler)
+{
+        if (!g_descriptorPool || texture == IMGUI_TEXTURE_WHITE || texture == IMGUI_TEXTURE_FONT)
+                return false;
+        VulkanTexture* tex = findTexture(texture);
+        if (tex)
+        {
+                // Draws recorded so far may still sample the old set.
+                freeRetiredSets();
+                if (g_retiredCount >= MAX_RETIRED)
+                        return false;
+                g_retired[g_retiredCount].set = tex->set;
+                g_retired[g_retiredCount].draw = g_drawCount;
+                g_retiredCount++;
+                *tex = g_textures[--g_textureCount];
+        }
+        if (!view)
+                return true;
+        if (g_textureCount >= MAX_TEXTURES)
+                return false;
+        VkDescriptorSet set = allocateSet(view, sampler);
+        if (!set)
+                return false;
+        tex = &g_textures[g_textureCount++];
+        tex->handle = texture;
+        tex->set = set;
+        return true;
+}
+
+// Framebuffer rect of a clip, flipped to Vulkan's top-down rows and kept
+// inside the framebuffer as vkCmdSetScissor requires.
+static VkRect2D scissorRect(const imguiDrawCmd& cmd, int width, int height)
+{
+        int x0 = 0, y0 = 0, x1 = width, y1 = height;
+        if (cmd.clip)
+        {
+                x0 = cmd.clipX > 0 ? cmd.clipX : 0;
+                y0 = height - (cmd.clipY + cmd.clipH);
+                y0 = y0 > 0 ? y0 : 0;
+                x1 = cmd.clipX + cmd.clipW < width ? cmd.clipX + cmd.clipW : width;
+                y1 = height - cmd.clipY < height ? height - cmd.clipY : height;
+        }
+        VkRect2D rect;
+        rect.offset.x = x0;
+        rect.offset.y = y0;
+        rect.extent.width = x1 > x0 ? (uint32_t)(x1 - x0) : 0;
+        rect.extent.height = y1 > y0 ? (uint32_t)(y1 - y0) : 0;
+        return rect;
+}
+
+// Returns false, recording nothing, when out of memory.
+static bool recordDraws(VkCommandBuffer cmd, int width, int height, imguiFrameStats* stats)
+{
+        // Vertices then indices in this frame's slot, which the caller has
+        // waited for. Vertex bytes are a multiple of 4, so indices stay aligned.
+        VulkanBuffer& frame = g_frames[g_frameIndex];
+        const VkDeviceSize vertexBytes = g_drawList.vertexCount*sizeof(imguiVertex);
+        const VkDeviceSize indexBytes = g_drawList.indexCount*sizeof(unsigned short);
+        if (!reserveBuffer(frame, vertexBytes + indexBytes))
+                return false;
+        g_frameIndex = (g_frameIndex + 1) % g_info.framesInFlight;
+        memcpy(frame.mapped, g_drawList.vertices, (size_t)vertexBytes);
+        memcpy((char*)frame.mapped + vertexBytes, g_drawList.indices, (size_t)indexBytes);
+        stats->uploadBytes += (int)(vertexBytes + indexBytes);
+
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipeline);
+        const VkDeviceSize vertexOffset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &frame.buffer, &vertexOffset);
+        vkCmdBindIndexBuffer(cmd, frame.buffer, vertexBytes, VK_INDEX_TYPE_UINT16);
+
+        VkViewport viewport;
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float)width;
+        viewport.height = (float)height;
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+
+        // Queue coordinates have y up, Vulkan's clip space y down.
+        VertexTransform transform;
+        transform.scale[0] = 2.0f / width;
+        transform.scale[1] = -2.0f / height;
+        transform.translate[0] = -1.0f;
+        transform.translate[1] = 1.0f;
+        vkCmdPushConstants(cmd, g_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(transform), &transform);
+
+        // White draws keep whatever set is bound, like the font does.
+        VkDescriptorSet boundSet = VK_NULL_HANDLE;
+        const FragmentMode* mode = 0;
+        VkRect2D scissor;
+        memset(&scissor, 0, sizeof(scissor));
+        bool scissorSet = false;
+        for (unsigned i = 0; i < g_drawList.cmdCount; ++i)
+        {
+                const imguiDrawCmd& dc = g_drawList.cmds[i];
+
+                const VkRect2D rect = scissorRect(dc, width, height);
+                if (!scissorSet || rect.offset.x != scissor.offset.x || rect.offset.y != scissor.offset.y ||
+                    rect.extent.width != scissor.extent.width || rect.extent.height != scissor.extent.height)
+                {
+                        vkCmdSetScissor(cmd, 0, 1, &rect);
+                        if (scissorSet)
+                                stats->scissorChanges++;
+                        scissor = rect;
+                        scissorSet = true;
+                }
+
+                VkDescriptorSet set = boundSet;
+                const FragmentMode* drawMode = &MODE_WHITE;
+                if (dc.texture == IMGUI_TEXTURE_FONT)
+                {
+                        set = g_fontSet;
+                        drawMode = &MODE_FONT;
+                }
+                else if (dc.texture != IMGUI_TEXTURE_WHITE)
+                {
+                        const VulkanTexture* tex = findTexture(dc.texture);
+                        if (!tex)
+                        {
+                                stats->droppedDraws++;
+                                continue;
+                        }
+                        set = tex->set;
+                        drawMode = &MODE_IMAGE;
+                }
+                if (!set)
+                        set = g_fontSet;
+                if (set != boundSet)
+                {
+                        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_pipelineLayout, 0, 1, &set, 0, 0);
+                        boundSet = set;
+                        stats->textureBinds++;
+                }
+                if (drawMode != mode)
+                {
+                        vkCmdPushConstants(cmd, g_pipelineLayout, VK_SHADER_STAGE_FRAGMENT_BIT,
+                                           sizeof(VertexTransform), sizeof(FragmentMode), drawMode);
+                        mode = drawMode;
+                }
+
+                vkCmdDrawIndexed(cmd, dc.indexCount, 1, dc.indexOffset, (int32_t)dc.vertexOffset, 0);
+                stats->drawCalls++;
+        }
+        return true;
+}
+
+void imguiRenderVulkanDraw(VkCommandBuffer cmd, int width, int height)
+{
+        IMGUI_PROFILE_SCOPE("imguiRenderVulkanDraw");
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        const imguiGfxCmd* q = imguiGetRenderQueue();
+        int nq = imguiGetRenderQueueSize();
+        imguiFrameStats* stats = imguiGetFrameStats();
+
+        IMGUI_PROFILE_BEGIN("tessellate");
+        imguiTessellate(&g_drawList, q, nq);
+        IMGUI_PROFILE_END();
+        stats->vertices += (int)g_drawList.vertexCount;
+        stats->indices += (int)g_drawList.indexCount;
+        stats->batchesSaved += (int)g_drawList.batchesSaved;
+
+        IMGUI_PROFILE_BEGIN("record");
+        if (g_pipeline && g_drawList.cmdCount && width > 0 && height > 0)
+                recordDraws(cmd, width, height, stats);
+        IMGUI_PROFILE_END();
+        g_drawCount++;
+        freeRetiredSets();
+
+        stats->renderTime += std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,67 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_RENDER_VULKAN_H
+#define IMGUI_RENDER_VULKAN_H
+
+#include <string>
+#include <vulkan/vulkan.h>
+#include <yip-imports/resource_loader.h>
+
+// Vulkan renderer for the imgui render queue. The application owns the
+// device, the render pass and the command buffers; the renderer records the
+// UI into a command buffer inside a render pass instance compatible with
+// 'renderPass'. Framebuffer coordinates match imguiRenderGL3: y = 0 is the
+// bottom row.
+struct imguiVulkanInitInfo
+{
+        VkPhysicalDevice physicalDevice;
+        VkDevice device;
+        VkQueue queue;                  // Used once to upload the font atlas.
+        uint32_t queueFamilyIndex;
+        VkRenderPass renderPass;
+        uint32_t subpass;
+        VkSampleCountFlagBits samples;
+        // Frames recorded before the first one is known to be complete, 1 to 8.
+        // Vertex and index buffers are kept per frame and reused in turn.
+        uint32_t framesInFlight;
+        VkPipelineCache pipelineCache;          // May be VK_NULL_HANDLE.
+        const VkAllocationCallbacks* allocator; // May be null.
+};
+
+bool imguiRenderVulkanInit(const imguiVulkanInitInfo& info, Resource::Loader & loader, const std::string & fontpath);
+bool imguiRenderVulkanInit(const imguiVulkanInitInfo& info, const unsigned char* ttfData);
+// Call once the device no longer uses anything the renderer recorded.
+void imguiRenderVulkanDestroy();
+// Records the current render queue into 'cmd'. Each call takes the next of
+// the framesInFlight buffer slots, so the command buffer recorded that many
+// calls earlier must have finished executing.
+void imguiRenderVulkanDraw(VkCommandBuffer cmd, int width, int height);
+// Image view for image commands using 'texture', sampled with 'sampler' or
+// linearly when it is VK_NULL_HANDLE. The view must be in
+// VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL when drawn. A null view removes
+// the texture. Textures may be replaced or removed while frames are
+// pending: the old descriptor set is freed framesInFlight draws later, and
+// the old view and sampler must live until then. Up to 64 textures, and 64
+// replaced ones waiting to be freed. Image commands of unregistered
+// textures are skipped and counted in imguiFrameStats::droppedDraws.
+bool imguiRenderVulkanSetTexture(unsigned int texture, VkImageView view, VkSampler sampler = VK_NULL_HANDLE);
+
+#endif // IMGUI_RENDER_VULKAN_H
@@ -0,0 +1,1539 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "imguiTessellate.h"
+#include "imguiInternal.h"
+
+// drawPolygon's normal and fringe loops run on SSE2 or NEON when the target
+// has it. Define IMGUI_DISABLE_SIMD to use the scalar loops everywhere.
+#if !defined(IMGUI_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define IMGUI_TESS_SSE2
+#include <emmintrin.h>
+#elif !defined(IMGUI_DISABLE_SIMD) && (defined(__aarch64__) || defined(_M_ARM64))
+#define IMGUI_TESS_NEON
+#include <arm_neon.h>
+#endif
+
+// Some math headers don't have PI defined.
+static const float PI = 3.14159265f;
+
+#include <yip-imports/stb_truetype.h>
+
+static const unsigned TEMP_COORD_COUNT = 100;
+static float g_tempCoords[TEMP_COORD_COUNT*2];
+static float g_tempNormals[TEMP_COORD_COUNT*2];
+
+// Quarter circle tables for 1..MAX_CORNER_SEGMENTS segments. A corner of
+// radius r uses the fewest segments whose chord error stays below the arc
+// tolerance, i.e. r <= g_cornerMaxRadius[n].
+static const int MAX_CORNER_SEGMENTS = 16;
+static float g_cornerVerts[MAX_CORNER_SEGMENTS+1][(MAX_CORNER_SEGMENTS+1)*2];
+static float g_cornerMaxRadius[MAX_CORNER_SEGMENTS+1];
+static float g_arcTolerance = 0.25f;
+
+static stbtt_bakedchar g_cdata[96]; // ASCII 32..126 is 95 glyphs
+static int g_fontWidth = 0;
+static int g_fontHeight = 0;
+static float g_fontAscent = 0;
+static float g_fontDescent = 0;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct TessClip
+{
+        bool enabled;
+        short x, y, w, h;
+};
+
+static imguiDrawList* g_list = 0;
+static TessClip g_clip;
+// Clip to g_clip on the CPU instead of in the draw commands.
+static bool g_cpuClip = false;
+
+// Makes room for nverts vertices and nindices indices drawn with 'texture'.
+// Starts a new draw command when the texture or clip changes, or when the
+// 16-bit indices of the current one would overflow. Returns the index of
+// the first new vertex relative to the current draw command, or -1.
+static int allocGeometry(unsigned nverts, unsigned nindices, unsigned int texture)
+{
+        imguiDrawList* l = g_list;
+        if (!imguiReserve(l->vertices, l->vertexCapacity, l->vertexCount + nverts) ||
+            !imguiReserve(l->indices, l->indexCapacity, l->indexCount + nindices))
+                return -1;
+
+        const bool clip = g_clip.enabled && !g_cpuClip;
+        imguiDrawCmd* cmd = l->cmdCount > 0 ? &l->cmds[l->cmdCount-1] : 0;
+        if (!cmd || cmd->texture != texture || cmd->clip != clip ||
+            (clip && (cmd->clipX != g_clip.x || cmd->clipY != g_clip.y || cmd->clipW != g_clip.w || cmd->clipH != g_clip.h)) ||
+            l->vertexCount - cmd->vertexOffset + nverts > 0x10000)
+        {
+                if (!imguiReserve(l->cmds, l->cmdCapacity, l->cmdCount + 1))
+                        return -1;
+                cmd = &l->cmds[l->cmdCount++];
+                cmd->vertexOffset = l->vertexCount;
+                cmd->indexOffset = l->indexCount;
+                cmd->indexCount = 0;
+                cmd->texture = texture;
+                cmd->clip = clip;
+                cmd->clipX = g_clip.x;
+                cmd->clipY = g_clip.y;
+                cmd->clipW = g_clip.w;
+                cmd->clipH = g_clip.h;
+        }
+        cmd->indexCount += nindices;
+        return (int)(l->vertexCount - cmd->vertexOffset);
+}
+
+inline void addVertex(float x, float y, float u, float v, unsigned int col)
+{
+        imguiVertex& vtx = g_list->vertices[g_list->vertexCount++];
+        vtx.x = x;
+        vtx.y = y;
+        vtx.u = u;
+        vtx.v = v;
+        vtx.col = col;
+}
+
+inline void addTriangle(int a, int b, int c)
+{
+        unsigned short* idx = &g_list->indices[g_list->indexCount];
+        idx[0] = (unsigned short)a;
+        idx[1] = (unsigned short)b;
+        idx[2] = (unsigned short)c;
+        g_list->indexCount += 3;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Unit normal of the edge v0 -> v1, or zero for a degenerate edge.
+inline void edgeNormal(const float* v0, const float* v1, float* n)
+{
+        float dx = v1[0] - v0[0];
+        float dy = v1[1] - v0[1];
+        float d = sqrtf(dx*dx+dy*dy);
+        if (d > 0)
+        {
+                d = 1.0f/d;
+                dx *= d;
+                dy *= d;
+        }
+        n[0] = dy;
+        n[1] = -dx;
+}
+
+// Offsets p by r along the miter of the normals n0 and n1 of its edges.
+inline void fringeVertex(const float* p, const float* n0, const float* n1, float r, float* out)
+{
+        float dmx = (n0[0] + n1[0]) * 0.5f;
+        float dmy = (n0[1] + n1[1]) * 0.5f;
+        float   dmr2 = dmx*dmx + dmy*dmy;
+        if (dmr2 > 0.000001f)
+        {
+                float   scale = 1.0f / dmr2;
+                if (scale > 10.0f) scale = 10.0f;
+                dmx *= scale;
+                dmy *= scale;
+        }
+        out[0] = p[0]+dmx*r;
+        out[1] = p[1]+dmy*r;
+}
+
+// normals[j] is the normal of the edge from point j to point j+1. The SIMD
+// loops do two points per step, in the same operation order as the scalar
+// code, so SSE2 output is bit-identical to it.
+static void polygonNormals(const float* coords, unsigned n, float* normals)
+{
+        edgeNormal(&coords[(n-1)*2], &coords[0], &normals[(n-1)*2]);
+        unsigned i = 1;
+#if defined(IMGUI_TESS_SSE2)
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 negOdd = _mm_set_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+        for (; i+1 < n; i += 2)
+        {
+                const __m128 v0 = _mm_loadu_ps(&coords[(i-1)*2]);
+                const __m128 v1 = _mm_loadu_ps(&coords[i*2]);
+                __m128 d = _mm_sub_ps(v1, v0);
+                const __m128 sq = _mm_mul_ps(d, d);
+                const __m128 len = _mm_sqrt_ps(_mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1))));
+                const __m128 nz = _mm_cmpgt_ps(len, zero);
+                const __m128 dn = _mm_mul_ps(d, _mm_div_ps(_mm_set1_ps(1.0f), len));
+                d = _mm_or_ps(_mm_and_ps(nz, dn), _mm_andnot_ps(nz, d));
+                d = _mm_xor_ps(_mm_shuffle_ps(d, d, _MM_SHUFFLE(2,3,0,1)), negOdd);
+                _mm_storeu_ps(&normals[(i-1)*2], d);
+        }
+#elif defined(IMGUI_TESS_NEON)
+        const float32x4_t zero = vdupq_n_f32(0.0f);
+        const float signs[4] = { 1.0f, -1.0f, 1.0f, -1.0f };
+        const float32x4_t negOdd = vld1q_f32(signs);
+        for (; i+1 < n; i += 2)
+        {
+                const float32x4_t v0 = vld1q_f32(&coords[(i-1)*2]);
+                const float32x4_t v1 = vld1q_f32(&coords[i*2]);
+                float32x4_t d = vsubq_f32(v1, v0);
+                const float32x4_t sq = vmulq_f32(d, d);
+                const float32x4_t len = vsqrtq_f32(vaddq_f32(sq, vrev64q_f32(sq)));
+                const uint32x4_t nz = vcgtq_f32(len, zero);
+                const float32x4_t dn = vmulq_f32(d, vdivq_f32(vdupq_n_f32(1.0f), len));
+                d = vbslq_f32(nz, dn, d);
+                d = vmulq_f32(vrev64q_f32(d), negOdd);
+                vst1q_f32(&normals[(i-1)*2], d);
+        }
+#endif
+        for (; i < n; ++i)
+                edgeNormal(&coords[(i-1)*2], &coords[i*2], &normals[(i-1)*2]);
+}
+
+static void polygonFringe(const float* coords, const float* normals, unsigned n, float r, float* out)
+{
+        fringeVertex(&coords[0], &normals[(n-1)*2], &normals[0], r, &out[0]);
+        unsigned i = 1;
+#if defined(IMGUI_TESS_SSE2)
+        const __m128 half = _mm_set1_ps(0.5f);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 maxScale = _mm_set1_ps(10.0f);
+        const __m128 eps = _mm_set1_ps(0.000001f);
+        const __m128 rr = _mm_set1_ps(r);
+        for (; i+1 < n; i += 2)
+        {
+                const __m128 n0 = _mm_loadu_ps(&normals[(i-1)*2]);
+                const __m128 n1 = _mm_loadu_ps(&normals[i*2]);
+                __m128 dm = _mm_mul_ps(_mm_add_ps(n0, n1), half);
+                const __m128 sq = _mm_mul_ps(dm, dm);
+                const __m128 dmr2 = _mm_add_ps(sq, _mm_shuffle_ps(sq, sq, _MM_SHUFFLE(2,3,0,1)));
+                const __m128 scale = _mm_min_ps(_mm_div_ps(one, dmr2), maxScale);
+                const __m128 big = _mm_cmpgt_ps(dmr2, eps);
+                dm = _mm_or_ps(_mm_and_ps(big, _mm_mul_ps(dm, scale)), _mm_andnot_ps(big, dm));
+                _mm_storeu_ps(&out[i*2], _mm_add_ps(_mm_loadu_ps(&coords[i*2]), _mm_mul_ps(dm, rr)));
+        }
+#elif defined(IMGUI_TESS_NEON)
+        const float32x4_t maxScale = vdupq_n_f32(10.0f);
+        const float32x4_t eps = vdupq_n_f32(0.000001f);
+        for (; i+1 < n; i += 2)
+        {
+                const float32x4_t n0 = vld1q_f32(&normals[(i-1)*2]);
+                const float32x4_t n1 = vld1q_f32(&normals[i*2]);
+                float32x4_t dm = vmulq_n_f32(vaddq_f32(n0, n1), 0.5f);
+                const float32x4_t sq = vmulq_f32(dm, dm);
+                const float32x4_t dmr2 = vaddq_f32(sq, vrev64q_f32(sq));
+                const float32x4_t scale = vminq_f32(vdivq_f32(vdupq_n_f32(1.0f), dmr2), maxScale);
+                dm = vbslq_f32(vcgtq_f32(dmr2, eps), vmulq_f32(dm, scale), dm);
+                vst1q_f32(&out[i*2], vaddq_f32(vld1q_f32(&coords[i*2]), vmulq_n_f32(dm, r)));
+        }
+#endif
+        for (; i < n; ++i)
+                fringeVertex(&coords[i*2], &normals[(i-1)*2], &normals[i*2], r, &out[i*2]);
+}
+
+static void drawPolygon(const float* coords, unsigned numCoords, float r, unsigned int col)
+{
+        if (numCoords > TEMP_COORD_COUNT) numCoords = TEMP_COORD_COUNT;
+        if (numCoords < 3) return;
+
+        polygonNormals(coords, numCoords, g_tempNormals);
+        polygonFringe(coords, g_tempNormals, numCoords, r, g_tempCoords);
+
+        // Solid polygon followed by its transparent fringe.
+        const int base = allocGeometry(numCoords*2, numCoords*6 + (numCoords-2)*3, IMGUI_TEXTURE_WHITE);
+        if (base < 0) return;
+
+        const unsigned int colTransp = col & 0x00ffffff;
+        for (unsigned i = 0; i < numCoords; ++i)
+                addVertex(coords[i*2], coords[i*2+1], 0, 0, col);
+        for (unsigned i = 0; i < numCoords; ++i)
+                addVertex(g_tempCoords[i*2], g_tempCoords[i*2+1], 0, 0, colTransp);
+
+        const int n = (int)numCoords;
+        for (int i = 0, j = n-1; i < n; j=i++)
+        {
+                addTriangle(base+i, base+j, base+n+j);
+                addTriangle(base+n+j, base+n+i, base+i);
+        }
+        for (int i = 2; i < n; ++i)
+                addTriangle(base, base+i-1, base+i);
+}
+
+static void drawRect(float x, float y, float w, float h, float fth, unsigned int col)
+{
+        const float x0 = x+0.5f, y0 = y+0.5f;
+        const float x1 = x+w-0.5f, y1 = y+h-0.5f;
+        if (!(x1 > x0 && y1 > y0))
+        {
+                // Degenerate or inverted edges get drawPolygon's normals.
+                float verts[4*2] = { x0, y0, x1, y0, x1, y1, x0, y1 };
+                drawPolygon(verts, 4, fth, col);
+                return;
+        }
+
+        // Same vertices, in the same order, as drawPolygon on this quad.
+        // Its unit normals are d*(1/|d|), which need not round to exactly
+        // 1, so keep that arithmetic to stay bit-identical.
+        const float dx = x1 - x0, dy = y1 - y0;
+        const float hx = dx*(1.0f/dx) * 0.5f;
+        const float hy = dy*(1.0f/dy) * 0.5f;
+        float scale = 1.0f / (hy*hy + hx*hx);
+        if (scale > 10.0f) scale = 10.0f;
+        const float ox = hy*scale*fth;
+        const float oy = hx*scale*fth;
+
+        const int base = allocGeometry(8, 30, IMGUI_TEXTURE_WHITE);
+        if (base < 0) return;
+
+        const unsigned int colTransp = col & 0x00ffffff;
+        const float vx[8] = { x0, x1, x1, x0, x0-ox, x1+ox, x1+ox, x0-ox };
+        const float vy[8] = { y0, y0, y1, y1, y0-oy, y0-oy, y1+oy, y1+oy };
+        imguiVertex* vtx = &g_list->vertices[g_list->vertexCount];
+        for (int i = 0; i < 8; ++i)
+        {
+                vtx[i].x = vx[i];
+                vtx[i].y = vy[i];
+                vtx[i].u = 0;
+                vtx[i].v = 0;
+                vtx[i].col = i < 4 ? col : colTransp;
+        }
+        g_list->vertexCount += 8;
+
+        static const unsigned char tris[30] =
+        {
+                0,3,7, 7,4,0, 1,0,4, 4,5,1, 2,1,5, 5,6,2, 3,2,6, 6,7,3,
+                0,1,2, 0,2,3,
+        };
+        unsigned short* idx = &g_list->indices[g_list->indexCount];
+        for (int i = 0; i < 30; ++i)
+                idx[i] = (unsigned short)(base + tris[i]);
+        g_list->indexCount += 30;
+}
+
+static void initCornerTables()
+{
+        for (int n = 1; n <= MAX_CORNER_SEGMENTS; ++n)
+        {
+                for (int i = 0; i <= n; ++i)
+                {
+                        const float a = (float)i/(float)n * PI*0.5f;
+                        g_cornerVerts[n][i*2+0] = cosf(a);
+                        g_cornerVerts[n][i*2+1] = sinf(a);
+                }
+                // Sagitta of one segment: r*(1 - cos(step/2)).
+                g_cornerMaxRadius[n] = g_arcTolerance / (1.0f - cosf(PI*0.25f/(float)n));
+        }
+}
+
+static unsigned cornerSegments(float r)
+{
+        unsigned n = 1;
+        while (n < (unsigned)MAX_CORNER_SEGMENTS && r > g_cornerMaxRadius[n])
+                n++;
+        return n;
+}
+
+static void drawRoundedRect(float x, float y, float w, float h, float r, float fth, unsigned int col)
+{
+        const unsigned n = cornerSegments(r);
+        float verts[(MAX_CORNER_SEGMENTS+1)*4*2];
+        const float* cv = g_cornerVerts[n];
+        float* v = verts;
+
+        // Counter-clockwise from the right edge, each corner rotating the
+        // same quarter table.
+        for (unsigned i = 0; i <= n; ++i)
+        {
+                *v++ = x+w-r + cv[i*2]*r;
+                *v++ = y+h-r + cv[i*2+1]*r;
+        }
+
+        for (unsigned i = 0; i <= n; ++i)
+        {
+                *v++ = x+r - cv[i*2+1]*r;
+                *v++ = y+h-r + cv[i*2]*r;
+        }
+
+        for (unsigned i = 0; i <= n; ++i)
+        {
+                *v++ = x+r - cv[i*2]*r;
+                *v++ = y+r - cv[i*2+1]*r;
+        }
+
+        for (unsigned i = 0; i <= n; ++i)
+        {
+                *v++ = x+w-r + cv[i*2+1]*r;
+                *v++ = y+r - cv[i*2]*r;
+        }
+
+        drawPolygon(verts, (n+1)*4, fth, col);
+}
+
+
+static void drawLine(float x0, float y0, float x1, float y1, float r, float fth, unsigned int col)
+{
+        float dx = x1-x0;
+        float dy = y1-y0;
+        float d = sqrtf(dx*dx+dy*dy);
+        if (d > 0.0001f)
+        {
+                d = 1.0f/d;
+                dx *= d;
+                dy *= d;
+        }
+        float nx = dy;
+        float ny = -dx;
+        float verts[4*2];
+        r -= fth;
+        r *= 0.5f;
+        if (r < 0.01f) r = 0.01f;
+        dx *= r;
+        dy *= r;
+        nx *= r;
+        ny *= r;
+
+        verts[0] = x0-dx-nx;
+        verts[1] = y0-dy-ny;
+
+        verts[2] = x0-dx+nx;
+        verts[3] = y0-dy+ny;
+
+        verts[4] = x1+dx+nx;
+        verts[5] = y1+dy+ny;
+
+        verts[6] = x1+dx-nx;
+        verts[7] = y1+dy-ny;
+
+        drawPolygon(verts, 4, fth, col);
+}
+
+// Polylines get four vertices per point across the stroke: fringe, solid,
+// solid, fringe. Ends are squared off like drawLine(). Corners are mitered
+// up to IMGUI_MITER_LIMIT half widths and beveled past it, which takes a
+// second cross-section on the point. Long paths are split into pieces
+// sharing a point so indices stay 16-bit.
+static const unsigned POLYLINE_CHUNK = 4096;
+
+// Unit direction and length in pixels of each segment touching a chunk.
+static float g_polySegs[(POLYLINE_CHUNK+1)*3];
+
+static void addSection(float x, float y, const imguiStrokeSection& sec, float tx, float ty,
+                       float hw, float fth, unsigned int col, unsigned int colTransp)
+{
+        addVertex(x + sec.ax*(hw+fth) + tx, y + sec.ay*(hw+fth) + ty, 0, 0, colTransp);
+        addVertex(x + sec.ax*hw, y + sec.ay*hw, 0, 0, col);
+        addVertex(x - sec.bx*hw, y - sec.by*hw, 0, 0, col);
+        addVertex(x - sec.bx*(hw+fth) + tx, y - sec.by*(hw+fth) + ty, 0, 0, colTransp);
+}
+
+static void addStripQuads(int base, unsigned steps)
+{
+        for (unsigned k = 0; k < steps; ++k)
+        {
+                for (int j = 0; j < 3; ++j)
+                {
+                        const int a = base + (int)k*4 + j;
+                        addTriangle(a, a+1, a+5);
+                        addTriangle(a+5, a+4, a);
+                }
+        }
+}
+
+static void drawPolyline(const short* pts, unsigned n, float r, float fth, int flags, unsigned int col)
+{
+        if (!pts || n < 2) return;
+
+        // A closed path visits its first point again at the end.
+        const bool closed = (flags & IMGUI_POLYLINE_CLOSED) && n > 2;
+        const bool bevel = (flags & IMGUI_POLYLINE_BEVEL) != 0;
+        const unsigned m = closed ? n+1 : n;
+        const unsigned nsegs = m-1;
+
+        const float s = 1.0f/8.0f;
+        float hw = (r - fth)*0.5f;
+        if (hw < 0.01f) hw = 0.01f;
+        const unsigned int colTransp = col & 0x00ffffff;
+
+        for (unsigned first = 0; first+1 < m; first += POLYLINE_CHUNK-1)
+        {
+                const unsigned last = first + POLYLINE_CHUNK-1 < m-1 ? first + POLYLINE_CHUNK-1 : m-1;
+                const unsigned count = last - first + 1;
+
+                // Segments first-1 .. last, wrapping when closed. Zero length
+                // segments take the direction of the one before them.
+                float* segs = g_polySegs;
+                for (unsigned k = 0; k <= count; ++k)
+                {
+                        float* seg = &segs[k*3];
+                        int sk = (int)(first + k) - 1;
+                        if (closed)
+                                sk = (sk + (int)nsegs) % (int)nsegs;
+                        if (sk < 0 || sk >= (int)nsegs)
+                        {
+                                seg[0] = seg[1] = seg[2] = 0;
+                                continue;
+                        }
+                        imguiPolylineSegment(pts, (unsigned)sk % n, (unsigned)(sk+1) % n, seg);
+                        if (seg[2] == 0 && k > 0)
+                        {
+                                seg[0] = seg[-3];
+                                seg[1] = seg[-2];
+                        }
+                }
+                for (unsigned k = count; k-- > 0;)
+                {
+                        if (segs[k*3] == 0 && segs[k*3+1] == 0)
+                        {
+                                segs[k*3] = segs[k*3+3];
+                                segs[k*3+1] = segs[k*3+4];
+                        }
+                }
+
+                // A point shared with the previous chunk, or the start of a
+                // closed path, only emits its last section; the piece before
+                // it ends with the whole join.
+                const bool capStart = !closed && first == 0;
+                const bool capEnd = !closed && last == m-1;
+                const float reach = hw + fth;
+                imguiStrokeSection sec[2];
+                unsigned nsec = 0;
+                for (unsigned i = first; i <= last; ++i)
+                {
+                        const float* s0 = &segs[(i-first)*3];
+                        if ((i == 0 && capStart) || (i == m-1 && capEnd))
+                                nsec++;
+                        else if (i == first)
+                                nsec++;
+                        else
+                                nsec += (unsigned)imguiJoinSections(s0, s0+3, reach, bevel, sec);
+                }
+
+                const int base = allocGeometry(nsec*4, (nsec-1)*18 + (capStart ? 6 : 0) + (capEnd ? 6 : 0), IMGUI_TEXTURE_WHITE);
+                if (base < 0) return;
+
+                for (unsigned i = first; i <= last; ++i)
+                {
+                        const unsigned p = i % n;
+                        float x = pts[p*2]*s;
+                        float y = pts[p*2+1]*s;
+                        const float* s0 = &segs[(i-first)*3];
+                        if ((i == 0 && capStart) || (i == m-1 && capEnd))
+                        {
+                                const float* d = i == 0 ? s0+3 : s0;
+                                const float sign = i == 0 ? -1.0f : 1.0f;
+                                x += sign*d[0]*hw;
+                                y += sign*d[1]*hw;
+                                sec[0].ax = sec[0].bx = d[1];
+                                sec[0].ay = sec[0].by = -d[0];
+                                addSection(x, y, sec[0], sign*d[0]*fth, sign*d[1]*fth, hw, fth, col, colTransp);
+                                continue;
+                        }
+                        const int ns = imguiJoinSections(s0, s0+3, reach, bevel, sec);
+                        for (int j = i == first ? ns-1 : 0; j < ns; ++j)
+                                addSection(x, y, sec[j], 0, 0, hw, fth, col, colTransp);
+                }
+
+                addStripQuads(base, nsec-1);
+                if (capStart)
+                {
+                        addTriangle(base, base+1, base+2);
+                        addTriangle(base, base+2, base+3);
+                }
+                if (capEnd)
+                {
+                        const int v = base + (int)(nsec-1)*4;
+                        addTriangle(v, v+1, v+2);
+                        addTriangle(v, v+2, v+3);
+                }
+        }
+}
+
+// Fills between the bottom and top edges of (x, bottom), (x, top) pairs,
+// with a fringe on both edges.
+static void drawBand(const short* pts, unsigned n, float fth, unsigned int col)
+{
+        n /= 2;
+        if (!pts || n < 2) return;
+
+        const float s = 1.0f/8.0f;
+        const unsigned int colTransp = col & 0x00ffffff;
+
+        for (unsigned first = 0; first+1 < n; first += POLYLINE_CHUNK-1)
+        {
+                const unsigned last = first + POLYLINE_CHUNK-1 < n-1 ? first + POLYLINE_CHUNK-1 : n-1;
+                const unsigned count = last - first + 1;
+                const int base = allocGeometry(count*4, (count-1)*18, IMGUI_TEXTURE_WHITE);
+                if (base < 0) return;
+
+                for (unsigned i = first; i <= last; ++i)
+                {
+                        const float x = pts[i*4]*s;
+                        float lo = pts[i*4+1]*s;
+                        float hi = pts[i*4+3]*s;
+                        if (lo > hi)
+                        {
+                                const float t = lo;
+                                lo = hi;
+                                hi = t;
+                        }
+                        lo += fth*0.5f;
+                        hi -= fth*0.5f;
+                        if (lo > hi)
+                                lo = hi = (lo+hi)*0.5f;
+                        addVertex(x, lo-fth, 0, 0, colTransp);
+                        addVertex(x, lo, 0, 0, col);
+                        addVertex(x, hi, 0, 0, col);
+                        addVertex(x, hi+fth, 0, 0, colTransp);
+                }
+                addStripQuads(base, count-1);
+        }
+}
+
+// The 4*n points of an ellipse, counter-clockwise from +x, rotating the
+// quarter table for n segments.
+static void ellipsePoints(float cx, float cy, float rx, float ry, unsigned n, float* out)
+{
+        const float* cv = g_cornerVerts[n];
+        for (unsigned i = 0; i < n; ++i)
+        {
+                const float c = cv[i*2], s = cv[i*2+1];
+                out[i*2+0] = cx + c*rx;
+                out[i*2+1] = cy + s*ry;
+                out[(n+i)*2+0] = cx - s*rx;
+                out[(n+i)*2+1] = cy + c*ry;
+                out[(n*2+i)*2+0] = cx - c*rx;
+                out[(n*2+i)*2+1] = cy - s*ry;
+                out[(n*3+i)*2+0] = cx + s*rx;
+                out[(n*3+i)*2+1] = cy - c*ry;
+        }
+}
+
+// Ellipse inscribed in the rect, filled or as the ring between it and the
+// ellipse 'stroke' smaller, with as many segments as a rounded corner of
+// the larger radius.
+static void drawEllipse(float x, float y, float w, float h, float stroke, float fth, unsigned int col)
+{
+        const float rx = w*0.5f, ry = h*0.5f;
+        if (rx <= 0.5f || ry <= 0.5f) return;
+        const float cx = x + rx, cy = y + ry;
+        const unsigned n = cornerSegments(rx > ry ? rx : ry);
+        const unsigned count = n*4;
+        float verts[MAX_CORNER_SEGMENTS*4*2];
+
+        if (stroke <= 0 || stroke >= (rx < ry ? rx : ry))
+        {
+                ellipsePoints(cx, cy, rx-0.5f, ry-0.5f, n, verts);
+                drawPolygon(verts, count, fth, col);
+                return;
+        }
+
+        // Solid edges sit half a fringe inside the outer and inner ellipses,
+        // or meet near the middle of rings thinner than the fringe.
+        const float a = stroke > fth + 0.02f ? fth*0.5f : (stroke - 0.02f)*0.5f;
+        const float irx = rx - stroke, iry = ry - stroke;
+        const unsigned int colTransp = col & 0x00ffffff;
+        const int base = allocGeometry((count+1)*4, count*18, IMGUI_TEXTURE_WHITE);
+        if (base < 0) return;
+
+        ellipsePoints(0, 0, 1, 1, n, verts);
+        for (unsigned i = 0; i <= count; ++i)
+        {
+                const float c = verts[(i % count)*2], s = verts[(i % count)*2+1];
+                float nx = ry*c, ny = rx*s;
+                float d = 1.0f/sqrtf(nx*nx + ny*ny);
+                const float onx = nx*d, ony = ny*d;
+                nx = iry*c; ny = irx*s;
+                d = 1.0f/sqrtf(nx*nx + ny*ny);
+                const float inx = nx*d, iny = ny*d;
+                const float ox = cx + c*rx, oy = cy + s*ry;
+                const float ix = cx + c*irx, iy = cy + s*iry;
+                addVertex(ox + onx*fth*0.5f, oy + ony*fth*0.5f, 0, 0, colTransp);
+                addVertex(ox - onx*a, oy - ony*a, 0, 0, col);
+                addVertex(ix + inx*a, iy + iny*a, 0, 0, col);
+                addVertex(ix - inx*fth*0.5f, iy - iny*fth*0.5f, 0, 0, colTransp);
+        }
+        addStripQuads(base, count);
+}
+
+// Textured quad without a fringe. Consecutive images of the same texture
+// and clip land in the same draw command.
+static void drawImage(float x, float y, float w, float h, const imguiGfxImage& img, unsigned int texture)
+{
+        if (w <= 0 || h <= 0) return;
+        if (texture == IMGUI_TEXTURE_WHITE || texture == IMGUI_TEXTURE_FONT) return;
+        const int base = allocGeometry(4, 6, texture);
+        if (base < 0) return;
+        const float s = 1.0f/65535.0f;
+        const float u0 = img.u0*s, v0 = img.v0*s, u1 = img.u1*s, v1 = img.v1*s;
+        addVertex(x, y, u0, v1, 0xffffffff);
+        addVertex(x+w, y, u1, v1, 0xffffffff);
+        addVertex(x+w, y+h, u1, v0, 0xffffffff);
+        addVertex(x, y+h, u0, v0, 0xffffffff);
+        addTriangle(base, base+1, base+2);
+        addTriangle(base, base+2, base+3);
+}
+
+// Markers too small for a solid core are dots of the fringe alone: a fan
+// from the center out to fth, its alpha scaled by the circle's area.
+static void drawMarkerDots(const short* pts, unsigned count, float r, float fth, unsigned int col)
+{
+        const unsigned n = 2;
+        const unsigned nv = n*4;
+        float ring[n*4*2];
+        ellipsePoints(0, 0, fth, fth, n, ring);
+
+        const unsigned int colTransp = col & 0x00ffffff;
+        const unsigned int alpha = (unsigned int)((float)(col >> 24)*r*r*4.0f + 0.5f);
+        const unsigned int colCenter = colTransp | (alpha << 24);
+        const float s = 1.0f/8.0f;
+        for (unsigned m = 0; m < count; ++m)
+        {
+                const int base = allocGeometry(nv+1, nv*3, IMGUI_TEXTURE_WHITE);
+                if (base < 0) return;
+                const float x = pts[m*2]*s;
+                const float y = pts[m*2+1]*s;
+                addVertex(x, y, 0, 0, colCenter);
+                for (unsigned i = 0; i < nv; ++i)
+                        addVertex(x + ring[i*2], y + ring[i*2+1], 0, 0, colTransp);
+                for (unsigned i = 0, j = nv-1; i < nv; j=i++)
+                        addTriangle(base, base+1+j, base+1+i);
+        }
+}
+
+// Markers share one circle of radius r: its vertices and indices are made
+// once per command and each marker only translates them.
+static void drawMarkers(const short* pts, unsigned count, float r, float fth, unsigned int col)
+{
+        if (!pts || r <= 0) return;
+        if (r <= 0.5f)
+        {
+                drawMarkerDots(pts, count, r, fth, col);
+                return;
+        }
+
+        const unsigned n = cornerSegments(r);
+        const unsigned nv = n*4;
+        const unsigned nidx = nv*6 + (nv-2)*3;
+        float verts[MAX_CORNER_SEGMENTS*4*2];
+        ellipsePoints(0, 0, r-0.5f, r-0.5f, n, verts);
+        polygonNormals(verts, nv, g_tempNormals);
+        polygonFringe(verts, g_tempNormals, nv, fth, g_tempCoords);
+
+        // Same triangles as drawPolygon.
+        unsigned short tris[MAX_CORNER_SEGMENTS*4*9];
+        unsigned short* t = tris;
+        for (unsigned i = 0, j = nv-1; i < nv; j=i++)
+        {
+                *t++ = (unsigned short)i; *t++ = (unsigned short)j; *t++ = (unsigned short)(nv+j);
+                *t++ = (unsigned short)(nv+j); *t++ = (unsigned short)(nv+i); *t++ = (unsigned short)i;
+        }
+        for (unsigned i = 2; i < nv; ++i)
+        {
+                *t++ = 0; *t++ = (unsigned short)(i-1); *t++ = (unsigned short)i;
+        }
+
+        const float s = 1.0f/8.0f;
+        const unsigned int colTransp = col & 0x00ffffff;
+        for (unsigned m = 0; m < count; ++m)
+        {
+                const int base = allocGeometry(nv*2, nidx, IMGUI_TEXTURE_WHITE);
+                if (base < 0) return;
+                const float x = pts[m*2]*s;
+                const float y = pts[m*2+1]*s;
+                imguiVertex* vtx = &g_list->vertices[g_list->vertexCount];
+                for (unsigned i = 0; i < nv; ++i)
+                {
+                        imguiVertex& a = vtx[i];
+                        a.x = x + verts[i*2];
+                        a.y = y + verts[i*2+1];
+                        a.u = a.v = 0;
+                        a.col = col;
+                        imguiVertex& b = vtx[nv+i];
+                        b.x = x + g_tempCoords[i*2];
+                        b.y = y + g_tempCoords[i*2+1];
+                        b.u = b.v = 0;
+                        b.col = colTransp;
+                }
+                g_list->vertexCount += nv*2;
+                unsigned short* idx = &g_list->indices[g_list->indexCount];
+                for (unsigned i = 0; i < nidx; ++i)
+                        idx[i] = (unsigned short)(base + tris[i]);
+                g_list->indexCount += nidx;
+        }
+}
+
+static void getBakedQuad(stbtt_bakedchar *chardata, int pw, int ph, int char_index,
+                                                 float *xpos, float *ypos, stbtt_aligned_quad *q)
+{
+        stbtt_bakedchar *b = chardata + char_index;
+        int round_x = (int)floor(*xpos + b->xoff);
+        int round_y = (int)floor(*ypos - b->yoff);
+
+        q->x0 = (float)round_x;
+        q->y0 = (float)round_y;
+        q->x1 = (float)round_x + b->x1 - b->x0;
+        q->y1 = (float)round_y - b->y1 + b->y0;
+
+        q->s0 = b->x0 / (float)pw;
+        q->t0 = b->y0 / (float)pw;
+        q->s1 = b->x1 / (float)ph;
+        q->t1 = b->y1 / (float)ph;
+
+        *xpos += b->xadvance;
+}
+
+// Clips a glyph quad, whose y0 is its top, to g_clip along with its texture
+// coordinates. Returns false when nothing is left.
+static bool clipQuad(stbtt_aligned_quad& q)
+{
+        const float x0 = g_clip.x, y0 = g_clip.y;
+        const float x1 = (float)(g_clip.x + g_clip.w), y1 = (float)(g_clip.y + g_clip.h);
+        if (q.x1 <= x0 || q.x0 >= x1 || q.y0 <= y0 || q.y1 >= y1)
+                return false;
+        if (q.x0 < x0)
+        {
+                q.s0 += (q.s1 - q.s0)*(x0 - q.x0)/(q.x1 - q.x0);
+                q.x0 = x0;
+        }
+        if (q.x1 > x1)
+        {
+                q.s1 -= (q.s1 - q.s0)*(q.x1 - x1)/(q.x1 - q.x0);
+                q.x1 = x1;
+        }
+        if (q.y1 < y0)
+        {
+                q.t1 += (q.t0 - q.t1)*(y0 - q.y1)/(q.y0 - q.y1);
+                q.y1 = y0;
+        }
+        if (q.y0 > y1)
+        {
+                q.t0 -= (q.t0 - q.t1)*(q.y0 - y1)/(q.y0 - q.y1);
+                q.y0 = y1;
+        }
+        return true;
+}
+
+static float getTextLength(stbtt_bakedchar *chardata, const char* text)
+{
+        const imguiBakedGlyphs<stbtt_bakedchar> glyphs = { chardata };
+        return imguiTextWidth(text, glyphs);
+}
+
+static void drawText(float x, float y, const char *text, int align, unsigned int col)
+{
+        if (!g_fontWidth) return;
+        if (!text) return;
+
+        if (align == IMGUI_ALIGN_CENTER)
+                x -= getTextLength(g_cdata, text)/2;
+        else if (align == IMGUI_ALIGN_RIGHT)
+                x -= getTextLength(g_cdata, text);
+
+        const float ox = x;
+
+        while (*text)
+        {
+                int c = (unsigned char)*text;
+                if (c == '\t')
+                {
+                        x = ox + imguiNextTabStop(x - ox);
+                }
+                else if (c >= 32 && c < 128)
+                {
+                        stbtt_aligned_quad q;
+                        getBakedQuad(g_cdata, g_fontWidth, g_fontHeight, c-32, &x,&y,&q);
+
+                        if (!g_cpuClip || !g_clip.enabled || clipQuad(q))
+                        {
+                                const int base = allocGeometry(4, 6, IMGUI_TEXTURE_FONT);
+                                if (base < 0) return;
+                                addVertex(q.x0, q.y0, q.s0, q.t0, col);
+                                addVertex(q.x1, q.y0, q.s1, q.t0, col);
+                                addVertex(q.x1, q.y1, q.s1, q.t1, col);
+                                addVertex(q.x0, q.y1, q.s0, q.t1, col);
+                                addTriangle(base, base+2, base+1);
+                                addTriangle(base, base+3, base+2);
+                        }
+                }
+                ++text;
+        }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool imguiTessInit(const unsigned char* ttfData, unsigned char* fontBitmap, int width, int height)
+{
+        initCornerTables();
+
+        if (!ttfData || !fontBitmap)
+                return false;
+
+        stbtt_BakeFontBitmap(ttfData, 0, 15.0f, fontBitmap, width, height, 32,96, g_cdata);
+        g_fontWidth = width;
+        g_fontHeight = height;
+
+        float advances[96];
+        g_fontAscent = 0;
+        g_fontDescent = 0;
+        for (int i = 0; i < 96; ++i)
+        {
+                advances[i] = g_cdata[i].xadvance;
+                g_fontAscent = fmaxf(g_fontAscent, -g_cdata[i].yoff);
+                g_fontDescent = fmaxf(g_fontDescent, g_cdata[i].y1 - g_cdata[i].y0 + g_cdata[i].yoff);
+        }
+        imguiSetCharAdvances(advances, 32, 96);
+
+        return true;
+}
+
+static void tessellateCommand(const imguiGfxCmd& cmd)
+{
+        const float s = 1.0f/8.0f;
+
+        if (cmd.type == IMGUI_GFXCMD_RECT)
+        {
+                if (cmd.rect.r == 0)
+                {
+                        drawRect((float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
+                                         (float)cmd.rect.w*s-1, (float)cmd.rect.h*s-1,
+                                         1.0f, cmd.col);
+                }
+                else
+                {
+                        drawRoundedRect((float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
+                                                        (float)cmd.rect.w*s-1, (float)cmd.rect.h*s-1,
+                                                        (float)cmd.rect.r*s, 1.0f, cmd.col);
+                }
+        }
+        else if (cmd.type == IMGUI_GFXCMD_LINE)
+        {
+                drawLine(cmd.line.x0*s, cmd.line.y0*s, cmd.line.x1*s, cmd.line.y1*s, cmd.line.r*s, 1.0f, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TRIANGLE)
+        {
+                if (cmd.flags == 1)
+                {
+                        const float verts[3*2] =
+                        {
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s/2-0.5f,
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                        };
+                        drawPolygon(verts, 3, 1.0f, cmd.col);
+                }
+                if (cmd.flags == 2)
+                {
+                        const float verts[3*2] =
+                        {
+                                (float)cmd.rect.x*s+0.5f, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s/2-0.5f, (float)cmd.rect.y*s+0.5f,
+                                (float)cmd.rect.x*s+0.5f+(float)cmd.rect.w*s-1, (float)cmd.rect.y*s+0.5f+(float)cmd.rect.h*s-1,
+                        };
+                        drawPolygon(verts, 3, 1.0f, cmd.col);
+                }
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                drawText(cmd.text.x, cmd.text.y, cmd.text.text, cmd.text.align, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+        {
+                if (cmd.flags & IMGUI_POLYLINE_BAND)
+                        drawBand(cmd.poly.points, cmd.poly.count, 1.0f, cmd.col);
+                else if (cmd.flags & IMGUI_POLYLINE_MARKERS)
+                        drawMarkers(cmd.poly.points, cmd.poly.count, cmd.poly.r*s, 1.0f, cmd.col);
+                else
+                        drawPolyline(cmd.poly.points, cmd.poly.count, cmd.poly.r*s, 1.0f, cmd.flags, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_ELLIPSE)
+        {
+                drawEllipse((float)cmd.rect.x*s, (float)cmd.rect.y*s, (float)cmd.rect.w*s, (float)cmd.rect.h*s,
+                            (float)cmd.rect.r*s, 1.0f, cmd.col);
+        }
+        else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                drawImage((float)cmd.image.x*s, (float)cmd.image.y*s, (float)cmd.image.w*s, (float)cmd.image.h*s,
+                          cmd.image, cmd.col);
+        }
+}
+
+inline void setClip(const imguiGfxCmd& cmd)
+{
+        g_clip.enabled = cmd.flags != 0;
+        g_clip.x = cmd.rect.x;
+        g_clip.y = cmd.rect.y;
+        g_clip.w = cmd.rect.w;
+        g_clip.h = cmd.rect.h;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Reordering. Commands are grouped into batches of equal texture and clip.
+// A command joins the most recent batch of its kind when no batch after
+// that one overlaps it, so anything it covers or is covered by keeps its
+// order and the image is unchanged.
+
+static const unsigned REORDER_LOOKBACK = 64;
+static const unsigned BATCH_RECTS = 4;
+
+// Batches cover their commands with a few rects, so a grid of alternating
+// textures does not turn into one box per texture that blocks every row.
+struct ReorderBatch
+{
+        unsigned int texture;
+        TessClip clip;
+        float bounds[4];
+        unsigned rectCount;
+        float rects[BATCH_RECTS][4];
+        unsigned first, last;
+};
+
+static bool g_reorder = false;
+static ReorderBatch* g_batches = 0;
+static unsigned g_batchCapacity = 0;
+static unsigned* g_batchNext = 0;
+static unsigned g_batchNextCapacity = 0;
+// Clip of each command, when batches mix clips.
+static TessClip* g_batchClips = 0;
+static unsigned g_batchClipCapacity = 0;
+
+inline float minf(float a, float b) { return a < b ? a : b; }
+inline float maxf(float a, float b) { return a > b ? a : b; }
+
+// Texture a command draws with, or false when it draws nothing.
+static bool commandTexture(const imguiGfxCmd& cmd, unsigned int& texture)
+{
+        if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                texture = IMGUI_TEXTURE_FONT;
+                return cmd.text.text && g_fontWidth;
+        }
+        if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                texture = cmd.col;
+                return texture != IMGUI_TEXTURE_WHITE && texture != IMGUI_TEXTURE_FONT;
+        }
+        texture = IMGUI_TEXTURE_WHITE;
+        return cmd.type != IMGUI_GFXCMD_SCISSOR;
+}
+
+// Conservative bounds of the geometry of a command, fringe included, before
+// clipping.
+static void commandBounds(const imguiGfxCmd& cmd, float* b)
+{
+        const float s = 1.0f/8.0f;
+        float x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+        if (cmd.type == IMGUI_GFXCMD_LINE)
+        {
+                const float r = cmd.line.r*s;
+                x0 = minf(cmd.line.x0, cmd.line.x1)*s - r;
+                y0 = minf(cmd.line.y0, cmd.line.y1)*s - r;
+                x1 = maxf(cmd.line.x0, cmd.line.x1)*s + r;
+                y1 = maxf(cmd.line.y0, cmd.line.y1)*s + r;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_POLYLINE)
+        {
+                const short* p = cmd.poly.points;
+                if (!p || !cmd.poly.count)
+                {
+                        b[0] = b[1] = b[2] = b[3] = 0;
+                        return;
+                }
+                // Miters reach 4 half widths of the stroke and its fringe.
+                const float r = cmd.poly.r*s*2.0f;
+                x0 = x1 = p[0]*s;
+                y0 = y1 = p[1]*s;
+                for (unsigned i = 1; i < cmd.poly.count; ++i)
+                {
+                        x0 = minf(x0, p[i*2]*s);
+                        x1 = maxf(x1, p[i*2]*s);
+                        y0 = minf(y0, p[i*2+1]*s);
+                        y1 = maxf(y1, p[i*2+1]*s);
+                }
+                x0 -= r;
+                y0 -= r;
+                x1 += r;
+                y1 += r;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                const float len = getTextLength(g_cdata, cmd.text.text);
+                x0 = cmd.text.x;
+                if (cmd.text.align == IMGUI_ALIGN_CENTER)
+                        x0 -= len/2;
+                else if (cmd.text.align == IMGUI_ALIGN_RIGHT)
+                        x0 -= len;
+                x1 = x0 + len;
+                y0 = cmd.text.y - g_fontDescent;
+                y1 = cmd.text.y + g_fontAscent;
+        }
+        else if (cmd.type == IMGUI_GFXCMD_IMAGE)
+        {
+                x0 = cmd.image.x*s;
+                y0 = cmd.image.y*s;
+                x1 = x0 + cmd.image.w*s;
+                y1 = y0 + cmd.image.h*s;
+        }
+        else
+        {
+                x0 = cmd.rect.x*s;
+                y0 = cmd.rect.y*s;
+                x1 = x0 + cmd.rect.w*s;
+                y1 = y0 + cmd.rect.h*s;
+        }
+        b[0] = x0 - 2;
+        b[1] = y0 - 2;
+        b[2] = x1 + 2;
+        b[3] = y1 + 2;
+}
+
+inline void clipBounds(float* b)
+{
+        if (g_clip.enabled)
+        {
+                b[0] = maxf(b[0], (float)g_clip.x);
+                b[1] = maxf(b[1], (float)g_clip.y);
+                b[2] = minf(b[2], (float)(g_clip.x + g_clip.w));
+                b[3] = minf(b[3], (float)(g_clip.y + g_clip.h));
+        }
+}
+
+inline bool overlaps(const float* a, const float* b)
+{
+        return a[0] < b[2] && b[0] < a[2] && a[1] < b[3] && b[1] < a[3];
+}
+
+inline float mergeGrowth(const float* a, const float* b)
+{
+        const float w = maxf(a[2], b[2]) - minf(a[0], b[0]);
+        const float h = maxf(a[3], b[3]) - minf(a[1], b[1]);
+        return w*h - (a[2]-a[0])*(a[3]-a[1]) - (b[2]-b[0])*(b[3]-b[1]);
+}
+
+inline void mergeRect(float* a, const float* b)
+{
+        a[0] = minf(a[0], b[0]);
+        a[1] = minf(a[1], b[1]);
+        a[2] = maxf(a[2], b[2]);
+        a[3] = maxf(a[3], b[3]);
+}
+
+// Adds a rect to the batch. It grows a rect it overlaps, or when the batch
+// is full the one it grows the least.
+static void addBatchRect(ReorderBatch& batch, const float* b)
+{
+        if (!batch.rectCount)
+                memcpy(batch.bounds, b, sizeof(batch.bounds));
+        else
+                mergeRect(batch.bounds, b);
+        for (unsigned i = 0; i < batch.rectCount; ++i)
+        {
+                if (overlaps(batch.rects[i], b))
+                {
+                        mergeRect(batch.rects[i], b);
+                        return;
+                }
+        }
+        if (batch.rectCount < BATCH_RECTS)
+        {
+                memcpy(batch.rects[batch.rectCount++], b, sizeof(batch.rects[0]));
+                return;
+        }
+
+        unsigned best = 0;
+        float bestGrowth = mergeGrowth(batch.rects[0], b);
+        for (unsigned i = 1; i < batch.rectCount; ++i)
+        {
+                const float g = mergeGrowth(batch.rects[i], b);
+                if (g < bestGrowth)
+                {
+                        bestGrowth = g;
+                        best = i;
+                }
+        }
+        mergeRect(batch.rects[best], b);
+}
+
+static bool batchOverlaps(const ReorderBatch& batch, const float* b)
+{
+        if (!batch.rectCount || !overlaps(batch.bounds, b))
+                return false;
+        for (unsigned i = 0; i < batch.rectCount; ++i)
+                if (overlaps(batch.rects[i], b))
+                        return true;
+        return false;
+}
+
+inline bool sameClip(const TessClip& a, const TessClip& b)
+{
+        return a.enabled == b.enabled &&
+               (!a.enabled || (a.x == b.x && a.y == b.y && a.w == b.w && a.h == b.h));
+}
+
+// Clipped on the CPU, commands of any clip can share a batch.
+inline bool sameBatchClip(const TessClip& a, const TessClip& b)
+{
+        return g_cpuClip || sameClip(a, b);
+}
+
+// Builds the batches and returns their count, or 0 when out of memory.
+// 'runs' receives the number of batches the queue order would need.
+static unsigned buildBatches(const imguiGfxCmd* q, unsigned nq, unsigned& runs)
+{
+        if (!imguiReserve(g_batches, g_batchCapacity, nq) || !imguiReserve(g_batchNext, g_batchNextCapacity, nq) ||
+            (g_cpuClip && !imguiReserve(g_batchClips, g_batchClipCapacity, nq)))
+                return 0;
+
+        unsigned nbatches = 0;
+        unsigned int prevTexture = 0;
+        TessClip prevClip;
+        memset(&prevClip, 0, sizeof(prevClip));
+        runs = 0;
+
+        for (unsigned i = 0; i < nq; ++i)
+        {
+                const imguiGfxCmd& cmd = q[i];
+                if (cmd.type == IMGUI_GFXCMD_SCISSOR)
+                {
+                        setClip(cmd);
+                        continue;
+                }
+                unsigned int texture;
+                if (!commandTexture(cmd, texture))
+                        continue;
+                if (!runs || texture != prevTexture || !sameBatchClip(g_clip, prevClip))
+                        runs++;
+                prevTexture = texture;
+                prevClip = g_clip;
+
+                float b[4];
+                commandBounds(cmd, b);
+                clipBounds(b);
+                const bool empty = b[2] <= b[0] || b[3] <= b[1];
+
+                // Walk back past batches the command does not touch.
+                unsigned target = nbatches;
+                const unsigned stop = nbatches > REORDER_LOOKBACK ? nbatches - REORDER_LOOKBACK : 0;
+                for (unsigned j = nbatches; j > stop; --j)
+                {
+                        const ReorderBatch& batch = g_batches[j-1];
+                        if (batch.texture == texture && sameBatchClip(batch.clip, g_clip))
+                        {
+                                target = j-1;
+                                break;
+                        }
+                        if (!empty && batchOverlaps(batch, b))
+                                break;
+                }
+
+                g_batchNext[i] = ~0u;
+                if (g_cpuClip)
+                        g_batchClips[i] = g_clip;
+                if (target == nbatches)
+                {
+                        ReorderBatch& batch = g_batches[nbatches++];
+                        batch.texture = texture;
+                        batch.clip = g_clip;
+                        batch.rectCount = 0;
+                        batch.first = i;
+                        batch.last = i;
+                        if (!empty)
+                                addBatchRect(batch, b);
+                        continue;
+                }
+                ReorderBatch& batch = g_batches[target];
+                if (!empty)
+                        addBatchRect(batch, b);
+                g_batchNext[batch.last] = i;
+                batch.last = i;
+        }
+        return nbatches;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// CPU clipping. Commands inside the clip rect are tessellated as they are
+// and those outside are dropped. The triangles of a command crossing an
+// edge are clipped one by one: inside ones are kept and the rest replaced
+// by the polygon left after clipping, with interpolated uv and color.
+
+static imguiVertex* g_clipVerts = 0;
+static unsigned g_clipVertCapacity = 0;
+static unsigned char* g_clipCounts = 0;
+static unsigned g_clipCountCapacity = 0;
+static unsigned char* g_clipCodes = 0;
+static unsigned g_clipCodeCapacity = 0;
+
+inline unsigned lerpColor(unsigned a, unsigned b, float t)
+{
+        unsigned c = 0;
+        for (int i = 0; i < 32; i += 8)
+        {
+                const float ca = (float)((a >> i) & 0xff);
+                const float cb = (float)((b >> i) & 0xff);
+                c |= (unsigned)(ca + (cb - ca)*t + 0.5f) << i;
+        }
+        return c;
+}
+
+// Keeps the part of a convex polygon on the inside of one clip edge, where
+// x (or y when 'axis' is 1) times 'sign' is at least 'edge' times 'sign'.
+static unsigned clipPolygonEdge(const imguiVertex* in, unsigned n, imguiVertex* out, int axis, float edge, float sign)
+{
+        unsigned m = 0;
+        for (unsigned i = 0; i < n; ++i)
+        {
+                const imguiVertex& a = in[i];
+                const imguiVertex& b = in[i+1 < n ? i+1 : 0];
+                const float da = ((axis ? a.y : a.x) - edge)*sign;
+                const float db = ((axis ? b.y : b.x) - edge)*sign;
+                if (da >= 0)
+                        out[m++] = a;
+                if ((da >= 0) != (db >= 0))
+                {
+                        const float t = da/(da - db);
+                        imguiVertex& v = out[m++];
+                        v.x = axis ? a.x + (b.x - a.x)*t : edge;
+                        v.y = axis ? edge : a.y + (b.y - a.y)*t;
+                        v.u = a.u + (b.u - a.u)*t;
+                        v.v = a.v + (b.v - a.v)*t;
+                        v.col = lerpColor(a.col, b.col, t);
+                }
+        }
+        return m;
+}
+
+// Clips the triangles added since vertex 'firstVertex' and index
+// 'firstIndex', which start in draw command 'firstCmd'.
+static void clipGeometry(unsigned firstCmd, unsigned firstVertex, unsigned firstIndex)
+{
+        imguiDrawList* l = g_list;
+        const float x0 = g_clip.x, y0 = g_clip.y;
+        const float x1 = (float)(g_clip.x + g_clip.w), y1 = (float)(g_clip.y + g_clip.h);
+
+        // Bounds are conservative, so most commands that reach here are
+        // inside after all.
+        if (!imguiReserve(g_clipCodes, g_clipCodeCapacity, l->vertexCount - firstVertex))
+                return;
+        unsigned char* codes = g_clipCodes - firstVertex;
+        unsigned any = 0;
+        for (unsigned i = firstVertex; i < l->vertexCount; ++i)
+        {
+                const imguiVertex& v = l->vertices[i];
+                const unsigned code = (v.x < x0 ? 1 : 0) | (v.x > x1 ? 2 : 0) | (v.y < y0 ? 4 : 0) | (v.y > y1 ? 8 : 0);
+                codes[i] = (unsigned char)code;
+                any |= code;
+        }
+        if (!any)
+                return;
+
+        unsigned nverts = 0, npolys = 0;
+        unsigned int texture = IMGUI_TEXTURE_WHITE;
+        for (unsigned c = firstCmd; c < l->cmdCount; ++c)
+        {
+                imguiDrawCmd& cmd = l->cmds[c];
+                const imguiVertex* verts = l->vertices + cmd.vertexOffset;
+                const unsigned char* cmdCodes = codes + cmd.vertexOffset;
+                unsigned short* idx = l->indices;
+                const unsigned begin = firstIndex > cmd.indexOffset ? firstIndex : cmd.indexOffset;
+                const unsigned end = cmd.indexOffset + cmd.indexCount;
+                texture = cmd.texture;
+                unsigned w = begin;
+                for (unsigned i = begin; i < end; i += 3)
+                {
+                        const unsigned c0 = cmdCodes[idx[i]], c1 = cmdCodes[idx[i+1]], c2 = cmdCodes[idx[i+2]];
+                        if (!(c0 | c1 | c2))
+                        {
+                                idx[w] = idx[i];
+                                idx[w+1] = idx[i+1];
+                                idx[w+2] = idx[i+2];
+                                w += 3;
+                                continue;
+                        }
+                        if (c0 & c1 & c2)
+                                continue;
+
+                        if (!imguiReserve(g_clipVerts, g_clipVertCapacity, nverts + 7) ||
+                            !imguiReserve(g_clipCounts, g_clipCountCapacity, npolys + 1))
+                                continue;
+                        imguiVertex a[8], b[8];
+                        a[0] = verts[idx[i]];
+                        a[1] = verts[idx[i+1]];
+                        a[2] = verts[idx[i+2]];
+                        unsigned n = 3;
+                        n = clipPolygonEdge(a, n, b, 0, x0, 1.0f);
+                        n = clipPolygonEdge(b, n, a, 0, x1, -1.0f);
+                        n = clipPolygonEdge(a, n, b, 1, y0, 1.0f);
+                        n = clipPolygonEdge(b, n, a, 1, y1, -1.0f);
+                        if (n < 3)
+                                continue;
+                        memcpy(g_clipVerts + nverts, a, n*sizeof(imguiVertex));
+                        nverts += n;
+                        g_clipCounts[npolys++] = (unsigned char)n;
+                }
+
+                // Only the last command can shrink; triangles dropped from
+                // an earlier one become degenerate.
+                if (c == l->cmdCount-1)
+                {
+                        cmd.indexCount -= end - w;
+                        l->indexCount = w;
+                }
+                else
+                {
+                        memset(idx + w, 0, (end - w)*sizeof(unsigned short));
+                }
+        }
+
+        if (l->cmdCount && !l->cmds[l->cmdCount-1].indexCount)
+                l->cmdCount--;
+
+        const imguiVertex* v = g_clipVerts;
+        for (unsigned p = 0; p < npolys; ++p)
+        {
+                const unsigned n = g_clipCounts[p];
+                const int base = allocGeometry(n, (n-2)*3, texture);
+                if (base < 0)
+                        return;
+                for (unsigned i = 0; i < n; ++i)
+                        addVertex(v[i].x, v[i].y, v[i].u, v[i].v, v[i].col);
+                for (unsigned i = 2; i < n; ++i)
+                        addTriangle(base, base+i-1, base+i);
+                v += n;
+        }
+}
+
+static void emitCommand(const imguiGfxCmd& cmd)
+{
+        if (!g_cpuClip || !g_clip.enabled)
+        {
+                tessellateCommand(cmd);
+                return;
+        }
+        unsigned int texture;
+        if (!commandTexture(cmd, texture))
+                return;
+
+        const float x0 = g_clip.x, y0 = g_clip.y;
+        const float x1 = (float)(g_clip.x + g_clip.w), y1 = (float)(g_clip.y + g_clip.h);
+
+        // Glyphs are clipped as they are made, lines above or below the clip
+        // are dropped without measuring them.
+        if (cmd.type == IMGUI_GFXCMD_TEXT)
+        {
+                if (cmd.text.y + g_fontAscent + 2 > y0 && cmd.text.y - g_fontDescent - 2 < y1)
+                        tessellateCommand(cmd);
+                return;
+        }
+
+        float b[4];
+        commandBounds(cmd, b);
+        if (b[2] <= x0 || b[0] >= x1 || b[3] <= y0 || b[1] >= y1)
+                return;
+        if (b[0] >= x0 && b[2] <= x1 && b[1] >= y0 && b[3] <= y1)
+        {
+                tessellateCommand(cmd);
+                return;
+        }
+
+        const unsigned firstCmd = g_list->cmdCount ? g_list->cmdCount-1 : 0;
+        const unsigned firstVertex = g_list->vertexCount;
+        const unsigned firstIndex = g_list->indexCount;
+        tessellateCommand(cmd);
+        clipGeometry(firstCmd, firstVertex, firstIndex);
+}
+
+void imguiTessellate(imguiDrawList* list, const imguiGfxCmd* q, int nq)
+{
+        g_list = list;
+        list->vertexCount = 0;
+        list->indexCount = 0;
+        list->cmdCount = 0;
+        list->batchesSaved = 0;
+        memset(&g_clip, 0, sizeof(g_clip));
+
+        unsigned runs = 0;
+        const unsigned nbatches = g_reorder && nq > 0 ? buildBatches(q, (unsigned)nq, runs) : 0;
+        if (nbatches)
+        {
+                list->batchesSaved = runs - nbatches;
+                for (unsigned j = 0; j < nbatches; ++j)
+                {
+                        g_clip = g_batches[j].clip;
+                        for (unsigned i = g_batches[j].first; i != ~0u; i = g_batchNext[i])
+                        {
+                                if (g_cpuClip)
+                                        g_clip = g_batchClips[i];
+                                emitCommand(q[i]);
+                        }
+                }
+        }
+        else
+        {
+                for (int i = 0; i < nq; ++i)
+                {
+                        if (q[i].type == IMGUI_GFXCMD_SCISSOR)
+                                setClip(q[i]);
+                        else
+                                emitCommand(q[i]);
+                }
+        }
+
+        g_list = 0;
+}
+
+void imguiTessSetReorder(bool enabled)
+{
+        g_reorder = enabled;
+}
+
+void imguiTessSetCpuClip(bool enabled)
+{
+        g_cpuClip = enabled;
+}
+
+void imguiTessSetArcTolerance(float pixels)
+{
+        g_arcTolerance = pixels > 0.01f ? pixels : 0.01f;
+        initCornerTables();
+}
+
+void imguiTessFreeDrawList(imguiDrawList* list)
+{
+        imguiFree(list->vertices);
+        imguiFree(list->indices);
+        imguiFree(list->cmds);
+        *list = imguiDrawList();
+
+        imguiFree(g_batches);
+        g_batches = 0;
+        g_batchCapacity = 0;
+        imguiFree(g_batchNext);
+        g_batchNext = 0;
+        g_batchNextCapacity = 0;
+        imguiFree(g_batchClips);
+        g_batchClips = 0;
+        g_batchClipCapacity = 0;
+        imguiFree(g_clipVerts);
+        g_clipVerts = 0;
+        g_clipVertCapacity = 0;
+        imguiFree(g_clipCounts);
+        g_clipCounts = 0;
+        g_clipCountCapacity = 0;
+        imguiFree(g_clipCodes);
+        g_clipCodes = 0;
+        g_clipCodeCapacity = 0;
+}
@@ -0,0 +1,91 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+#ifndef IMGUI_TESSELLATE_H
+#define IMGUI_TESSELLATE_H
+
+#include "imgui.h"
+
+// Turns the render queue into indexed triangles, independent of any
+// graphics API. Renderers upload the vertices and issue one draw per
+// imguiDrawCmd.
+
+// Draw command textures. Anything else is the handle of an image command.
+enum imguiTessTexture
+{
+        IMGUI_TEXTURE_WHITE = 0,
+        IMGUI_TEXTURE_FONT = 0xffffffffu,
+};
+
+struct imguiVertex
+{
+        float x, y;
+        float u, v;
+        unsigned int col;
+};
+
+// Indices are relative to vertexOffset so they always fit in 16 bits.
+struct imguiDrawCmd
+{
+        unsigned int vertexOffset;
+        unsigned int indexOffset;
+        unsigned int indexCount;
+        unsigned int texture;
+        bool clip;
+        short clipX, clipY, clipW, clipH;
+};
+
+struct imguiDrawList
+{
+        imguiDrawList() :
+                vertices(0), indices(0), cmds(0),
+                vertexCount(0), indexCount(0), cmdCount(0),
+                vertexCapacity(0), indexCapacity(0), cmdCapacity(0),
+                batchesSaved(0)
+        {
+        }
+
+        imguiVertex* vertices;
+        unsigned short* indices;
+        imguiDrawCmd* cmds;
+        unsigned vertexCount, indexCount, cmdCount;
+        unsigned vertexCapacity, indexCapacity, cmdCapacity;
+        // Texture or clip changes avoided by imguiTessSetReorder().
+        unsigned batchesSaved;
+};
+
+// Bakes the font into a width x height 8-bit coverage bitmap.
+bool imguiTessInit(const unsigned char* ttfData, unsigned char* fontBitmap, int width, int height);
+void imguiTessellate(imguiDrawList* list, const imguiGfxCmd* queue, int count);
+// Also releases scratch memory shared by all lists, which grows back on use.
+void imguiTessFreeDrawList(imguiDrawList* list);
+// Maximum distance in pixels between a rounded corner and its polygon,
+// 0.25 by default. Corners use 1 to 16 segments depending on radius.
+void imguiTessSetArcTolerance(float pixels);
+// Lets imguiTessellate() draw commands out of queue order, grouped by
+// texture and clip, where they do not overlap anything they pass. The
+// result looks the same with fewer draw commands. Off by default.
+void imguiTessSetReorder(bool enabled);
+// Clips geometry to the scroll area rects during tessellation instead of
+// leaving it to the renderer's scissor, so clip changes no longer split
+// draw commands and no draw command has clip set. Off by default.
+void imguiTessSetCpuClip(bool enabled);
+
+#endif // IMGUI_TESSELLATE_H
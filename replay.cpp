@@ -0,0 +1,235 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+// Replays a capture written with imguiCaptureFrame() through a renderer
+// without the application, and reports the render cost per frame.
+//
+//   c++ -O2 -std=c++11 -pthread replay.cpp imgui.cpp imguiCapture.cpp imguiRenderSoft.cpp imguiTessellate.cpp -o replay
+//   ./replay frames.imq --render tiled --threads 4 --repeat 10 --json
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "imguiCapture.h"
+#include "imguiRenderSoft.h"
+#include "imguiTessellate.h"
+
+struct Options
+{
+    const char* path;
+    const char* render;
+    int threads;
+    int repeat;
+    int frame;
+    const char* tga;
+    const char* font;
+    bool json;
+    bool reorder;
+    bool cpuClip;
+};
+
+static bool parseOptions(int argc, char** argv, Options& opt)
+{
+    opt.path = 0;
+    opt.render = "soft";
+    opt.threads = 0;
+    opt.repeat = 1;
+    opt.frame = -1;
+    opt.tga = 0;
+    opt.font = "DroidSans.ttf";
+    opt.json = false;
+    opt.reorder = false;
+    opt.cpuClip = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char* arg = argv[i];
+        const char* val = i+1 < argc ? argv[i+1] : 0;
+        if (strcmp(arg, "--json") == 0) { opt.json = true; continue; }
+        if (strcmp(arg, "--reorder") == 0) { opt.reorder = true; continue; }
+        if (strcmp(arg, "--cpu-clip") == 0) { opt.cpuClip = true; continue; }
+        if (arg[0] != '-') { opt.path = arg; continue; }
+        if (!val) { fprintf(stderr, "Missing value for %s\n", arg); return false; }
+        if (strcmp(arg, "--render") == 0) opt.render = val;
+        else if (strcmp(arg, "--threads") == 0) opt.threads = atoi(val);
+        else if (strcmp(arg, "--repeat") == 0) opt.repeat = atoi(val);
+        else if (strcmp(arg, "--frame") == 0) opt.frame = atoi(val);
+        else if (strcmp(arg, "--tga") == 0) opt.tga = val;
+        else if (strcmp(arg, "--font") == 0) opt.font = val;
+        else { fprintf(stderr, "Unknown option '%s'\n", arg); return false; }
+        ++i;
+    }
+    if (!opt.path || opt.repeat < 1)
+        return false;
+    if (strcmp(opt.render, "soft") != 0 && strcmp(opt.render, "tiled") != 0 && strcmp(opt.render, "tess") != 0)
+    {
+        fprintf(stderr, "Unknown renderer '%s' (soft, tiled, tess)\n", opt.render);
+        return false;
+    }
+    return true;
+}
+
+static bool loadFile(const char* path, std::string& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        data.append(buf, n);
+    fclose(fp);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseOptions(argc, argv, opt))
+    {
+        fprintf(stderr, "usage: %s capture.imq [--render soft|tiled|tess] [--threads T] [--repeat N]\n"
+                        "       [--frame F] [--tga out.tga] [--font path] [--reorder] [--cpu-clip] [--json]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    if (!imguiReplayOpen(opt.path))
+    {
+        fprintf(stderr, "Could not open capture '%s'.\n", opt.path);
+        return EXIT_FAILURE;
+    }
+    const int frameCount = imguiReplayFrameCount();
+    const int first = opt.frame >= 0 ? opt.frame : 0;
+    const int last = opt.frame >= 0 ? opt.frame+1 : frameCount;
+    if (first >= frameCount)
+    {
+        fprintf(stderr, "Frame %d out of range (%d frames).\n", first, frameCount);
+        return EXIT_FAILURE;
+    }
+
+    const bool tess = strcmp(opt.render, "tess") == 0;
+    std::string ttf;
+    std::vector<unsigned char> fontBitmap(512*512);
+    if (!loadFile(opt.font, ttf) ||
+        !(tess ? imguiTessInit((const unsigned char*)ttf.data(), &fontBitmap[0], 512, 512)
+               : imguiRenderSoftInit((const unsigned char*)ttf.data())))
+    {
+        fprintf(stderr, "Could not load font '%s'.\n", opt.font);
+        return EXIT_FAILURE;
+    }
+
+    imguiTessSetReorder(opt.reorder);
+    imguiTessSetCpuClip(opt.cpuClip);
+
+    imguiDrawList drawList;
+    std::vector<unsigned int> pixels;
+    std::vector<double> renderNs;
+    double commands = 0;
+    double draws = 0, saved = 0, vertices = 0;
+    int width = 0, height = 0;
+
+    typedef std::chrono::steady_clock Clock;
+    for (int r = 0; r < opt.repeat; ++r)
+    {
+        for (int frame = first; frame < last; ++frame)
+        {
+            if (!imguiReplayLoadFrame(frame, &width, &height))
+            {
+                fprintf(stderr, "Could not load frame %d.\n", frame);
+                return EXIT_FAILURE;
+            }
+            if ((size_t)width*height > pixels.size())
+                pixels.resize((size_t)width*height);
+
+            const Clock::time_point t0 = Clock::now();
+            if (tess)
+            {
+                imguiTessellate(&drawList, imguiGetRenderQueue(), imguiGetRenderQueueSize());
+            }
+            else if (width > 0 && height > 0)
+            {
+                imguiRenderSoftClear(&pixels[0], width, height, width, imguiRGBA(204,204,204));
+                if (strcmp(opt.render, "tiled") == 0)
+                    imguiRenderSoftDrawTiled(&pixels[0], width, height, width, opt.threads);
+                else
+                    imguiRenderSoftDraw(&pixels[0], width, height, width);
+            }
+            const Clock::time_point t1 = Clock::now();
+
+            renderNs.push_back((double)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+            commands += imguiGetRenderQueueSize();
+            draws += drawList.cmdCount;
+            saved += drawList.batchesSaved;
+            vertices += drawList.vertexCount;
+        }
+    }
+
+    if (opt.tga && !tess && width > 0 && height > 0)
+        imguiRenderSoftSaveTGA(opt.tga, &pixels[0], width, height, width);
+
+    if (tess)
+        imguiTessFreeDrawList(&drawList);
+    else
+        imguiRenderSoftDestroy();
+    imguiReplayClose();
+
+    const int n = (int)renderNs.size();
+    double mean = 0;
+    for (int i = 0; i < n; ++i)
+        mean += renderNs[i];
+    mean /= n;
+    commands /= n;
+    draws /= n;
+    saved /= n;
+    vertices /= n;
+    std::sort(renderNs.begin(), renderNs.end());
+    const double median = renderNs[n/2];
+    const double p99 = renderNs[(n-1)*99/100];
+
+    if (opt.json)
+    {
+        printf("{\"capture\": \"%s\", \"frames\": %d, \"repeat\": %d, \"render\": \"%s\", \"threads\": %d, "
+               "\"render_ns_per_frame\": %.0f, \"render_ns_median\": %.0f, \"render_ns_p99\": %.0f, \"commands_per_frame\": %.1f",
+               opt.path, last-first, opt.repeat, opt.render, opt.threads, mean, median, p99, commands);
+        if (tess)
+            printf(", \"reorder\": %s, \"cpu_clip\": %s, \"draws_per_frame\": %.1f, \"batches_saved_per_frame\": %.1f, "
+                   "\"vertices_per_frame\": %.1f",
+                   opt.reorder ? "true" : "false", opt.cpuClip ? "true" : "false", draws, saved, vertices);
+        printf("}\n");
+    }
+    else
+    {
+        printf("capture           %s, %d frames x %d\n", opt.path, last-first, opt.repeat);
+        printf("render ns/frame   mean %.0f  median %.0f  p99 %.0f (%s, %d threads)\n", mean, median, p99, opt.render, opt.threads);
+        printf("commands/frame    %.1f\n", commands);
+        if (tess)
+        {
+            printf("draws/frame       %.1f (%.1f batches saved by reordering)\n", draws, saved);
+            printf("vertices/frame    %.1f%s\n", vertices, opt.cpuClip ? " (clipped on the CPU)" : "");
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
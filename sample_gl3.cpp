@@ -86,15 +86,19 @@ int main( int argc, char **argv )
     int scrollarea1 = 0;
     int scrollarea2 = 0;
 
+    // A long series for the plot widget, decimated to the widget width.
+    static float series[200000];
+    for (int i = 0; i < 200000; ++i)
+        series[i] = sinf(i * 0.0002f) * 0.8f + ((i * 7919) % 101) / 500.f;
+
     // glfw scrolling
     int glfwscroll = 0;
+    int lastWidth = 0, lastHeight = 0;
     do
     {
         glfwGetWindowSize(&width, &height);
         glViewport(0, 0, width, height);
 
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
         // Draw UI
 
         // Mouse states
@@ -152,6 +156,9 @@ int main( int argc, char **argv )
         imguiLabel("Indented");
         imguiUnindent();
         imguiLabel("Unindented");
+        imguiParagraph("Paragraphs wrap to the width of the scroll area.\nLine breaks are cached until the text or the width changes.");
+        imguiPlot("Plot", series, 200000, -1.f, 1.f, 60);
+        imguiPlot("Area plot", series, 200000, -1.f, 1.f, 60, IMGUI_PLOT_AREA);
 
         imguiEndScrollArea();
 
@@ -172,6 +179,14 @@ int main( int argc, char **argv )
         imguiDrawLine(30 + width / 5 * 2, height - 100, 30 + width / 5 * 2 + 100, height - 80, 2.f, imguiRGBA(32, 32, 192, 192));
         imguiDrawLine(30 + width / 5 * 2, height - 120, 30 + width / 5 * 2 + 100, height - 100, 3.f, imguiRGBA(192, 32, 32,192));
 
+        float zigzag[8*2];
+        for (int i = 0; i < 8; ++i)
+        {
+            zigzag[i*2] = 30 + width / 5 * 2 + 150 + i * 14.f;
+            zigzag[i*2+1] = height - 120 + (i & 1 ? 40.f - i * 4.f : 0.f);
+        }
+        imguiDrawPolyline(zigzag, 8, 3.f, imguiRGBA(192, 192, 32, 192));
+
         imguiDrawRoundedRect(30 + width / 5 * 2, height - 240, 100, 100, 5.f, imguiRGBA(32,192, 32,192));
         imguiDrawRoundedRect(30 + width / 5 * 2, height - 350, 100, 100, 10.f, imguiRGBA(32, 32, 192, 192));
         imguiDrawRoundedRect(30 + width / 5 * 2, height - 470, 100, 100, 20.f, imguiRGBA(192, 32, 32,192));
@@ -180,6 +195,17 @@ int main( int argc, char **argv )
         imguiDrawRect(30 + width / 5 * 2, height - 710, 100, 100, imguiRGBA(32, 32, 192, 192));
         imguiDrawRect(30 + width / 5 * 2, height - 830, 100, 100, imguiRGBA(192, 32, 32,192));
 
+        // Skip drawing and throttle the loop when the frame did not change.
+        if (!imguiFrameChanged() && width == lastWidth && height == lastHeight)
+        {
+            glfwPollEvents();
+            glfwSleep(0.01);
+            continue;
+        }
+        lastWidth = width;
+        lastHeight = height;
+
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         imguiRenderGLDraw(width, height); 
 
         // Check for errors
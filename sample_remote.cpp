@@ -0,0 +1,211 @@
+//
+// Copyright (c) 2009-2010 Mikko Mononen memon@inside.org
+//
+// This software is provided 'as-is', without any express or implied
+// warranty.  In no event will the authors be held liable for any damages
+// arising from the use of this software.
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+//
+
+// Source altered and distributed from https://github.com/AdrienHerubel/imgui
+
+// Runs a UI in a child process and displays it in the parent through
+// imguiRemote, over two pipes or a loopback TCP connection. The parent sends
+// scripted input, optionally draws the last frame with the software renderer
+// and prints bandwidth and latency.
+//
+//   c++ -O2 -std=c++11 -pthread sample_remote.cpp imgui.cpp imguiCapture.cpp imguiRemote.cpp imguiRenderSoft.cpp -o sample_remote
+//   ./sample_remote --frames 500 --tcp 7000 --tga remote.tga
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include <string>
+#include <vector>
+
+#include "imgui.h"
+#include "imguiRemote.h"
+#include "imguiRenderSoft.h"
+
+static void buildUi(int width, int height)
+{
+    static bool checked = false;
+    static float value = 50.f;
+    static int scrollarea = 0;
+
+    imguiBeginScrollArea("Remote", 10, 10, width / 3, height - 20, &scrollarea);
+    imguiSeparatorLine();
+    imguiButton("Button");
+    if (imguiCheck("Checkbox", checked))
+        checked = !checked;
+    imguiSlider("Slider", &value, 0.f, 100.f, 1.f);
+    imguiParagraph("This UI is built in another process. Only the change against the previous frame is sent.");
+    for (int i = 0; i < 40; ++i)
+        imguiLabel("A wall of text");
+    imguiEndScrollArea();
+}
+
+static int runServer(int readFd, int writeFd)
+{
+    imguiRemoteServerInit(readFd, writeFd);
+    int mx, my, scroll, width, height;
+    unsigned char mbut;
+    while (imguiRemoteServerPollInput(&mx, &my, &mbut, &scroll, &width, &height))
+    {
+        if (width <= 0 || height <= 0)
+        {
+            usleep(1000);
+            continue;
+        }
+        imguiBeginFrame(mx, my, mbut, scroll);
+        buildUi(width, height);
+        imguiEndFrame();
+        if (!imguiRemoteServerSendFrame())
+            break;
+        usleep(1000);
+    }
+    imguiRemoteServerShutdown();
+    return EXIT_SUCCESS;
+}
+
+static bool loadFile(const char* path, std::string& data)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp)
+        return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0)
+        data.append(buf, n);
+    fclose(fp);
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    int frames = 300;
+    int port = 0;
+    const char* tga = 0;
+    const char* font = "DroidSans.ttf";
+    for (int i = 1; i+1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--frames") == 0) frames = atoi(argv[i+1]);
+        else if (strcmp(argv[i], "--tcp") == 0) port = atoi(argv[i+1]);
+        else if (strcmp(argv[i], "--tga") == 0) tga = argv[i+1];
+        else if (strcmp(argv[i], "--font") == 0) font = argv[i+1];
+        else
+        {
+            fprintf(stderr, "usage: %s [--frames N] [--tcp port] [--tga out.tga] [--font path]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    int toServer[2], toClient[2];
+    if (!port && (pipe(toServer) != 0 || pipe(toClient) != 0))
+        return EXIT_FAILURE;
+
+    const pid_t pid = fork();
+    if (pid < 0)
+        return EXIT_FAILURE;
+    if (pid == 0)
+    {
+        if (port)
+        {
+            const int fd = imguiRemoteListen("127.0.0.1", port);
+            if (fd < 0)
+                return EXIT_FAILURE;
+            const int res = runServer(fd, fd);
+            close(fd);
+            return res;
+        }
+        close(toServer[1]);
+        close(toClient[0]);
+        return runServer(toServer[0], toClient[1]);
+    }
+
+    int readFd, writeFd;
+    if (port)
+    {
+        readFd = writeFd = -1;
+        for (int i = 0; i < 100 && readFd < 0; ++i)
+        {
+            readFd = writeFd = imguiRemoteConnect("127.0.0.1", port);
+            if (readFd < 0)
+                usleep(10000);
+        }
+    }
+    else
+    {
+        close(toServer[0]);
+        close(toClient[1]);
+        readFd = toClient[0];
+        writeFd = toServer[1];
+    }
+    if (readFd < 0 || !imguiRemoteClientInit(readFd, writeFd))
+    {
+        fprintf(stderr, "Could not connect.\n");
+        return EXIT_FAILURE;
+    }
+
+    const int width = 800, height = 600;
+    int received = 0;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        // Sweep the mouse over the widgets and click every 40 frames.
+        const int mx = 20 + (frame*3) % (width/3);
+        const int my = height - 40 - (frame*7) % 200;
+        const unsigned char mbut = (frame % 40) < 4 ? IMGUI_MBUT_LEFT : 0;
+        imguiRemoteClientSendInput(mx, my, mbut, 0, width, height);
+        const int res = imguiRemoteClientReceiveFrame(1000);
+        if (res < 0)
+            break;
+        received += res;
+    }
+
+    const imguiRemoteStats stats = *imguiRemoteClientStats();
+    imguiRemoteClientShutdown();
+    if (port)
+        close(readFd);
+    else
+    {
+        close(readFd);
+        close(writeFd);
+    }
+    waitpid(pid, 0, 0);
+
+    if (tga && received > 0)
+    {
+        std::string ttf;
+        if (loadFile(font, ttf) && imguiRenderSoftInit((const unsigned char*)ttf.data()))
+        {
+            std::vector<unsigned int> pixels(width*height);
+            imguiRenderSoftClear(&pixels[0], width, height, width, imguiRGBA(204,204,204));
+            imguiRenderSoftDraw(&pixels[0], width, height, width);
+            imguiRenderSoftSaveTGA(tga, &pixels[0], width, height, width);
+            imguiRenderSoftDestroy();
+        }
+    }
+
+    const double n = stats.frames ? (double)stats.frames : 1.0;
+    printf("transport         %s\n", port ? "tcp loopback" : "pipe");
+    printf("frames            %u received, %d loaded\n", stats.frames, received);
+    printf("encoded/frame     %.0f bytes\n", (double)stats.rawBytes / n);
+    printf("received/frame    %.0f bytes (%.1f%%)\n", (double)stats.receivedBytes / n,
+           stats.rawBytes ? 100.0 * (double)stats.receivedBytes / (double)stats.rawBytes : 0.0);
+    printf("sent/frame        %.0f bytes\n", (double)stats.sentBytes / n);
+    printf("round trip        last %.3f ms, mean %.3f ms\n", stats.roundTripMs, stats.avgRoundTripMs);
+    return EXIT_SUCCESS;
+}